@@ -0,0 +1,124 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <malloc.h>
+#include <new>
+
+// Результат allocate_at_least: блок и его реальная вместимость в элементах
+template <typename T>
+struct AllocationResult {
+    T* ptr;
+    size_t count;
+};
+
+// Аллокатор поверх malloc/realloc/free. Умеет перевыделять блок через realloc, поэтому
+// Vector с тривиально перемещаемыми элементами растёт без копирования, если за блоком
+// есть свободное место. Большие блоки glibc обслуживает через mmap и растит их при помощи mremap.
+// allocate_at_least отдаёт весь блок, который malloc выделил на самом деле
+template <typename T>
+class MallocAllocator {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "malloc does not guarantee alignment of T");
+
+public:
+    using value_type = T;
+
+    MallocAllocator() noexcept = default;
+
+    template <typename U>
+    MallocAllocator(const MallocAllocator<U>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(Reallocate(nullptr, n));
+    }
+
+    AllocationResult<T> allocate_at_least(size_t n) {
+        T* p = allocate(n);
+        return {p, malloc_usable_size(p) / sizeof(T)};
+    }
+
+    void deallocate(T* p, size_t) noexcept {
+        std::free(p);
+    }
+
+    T* reallocate(T* p, size_t, size_t new_n) {
+        return static_cast<T*>(Reallocate(p, new_n));
+    }
+
+    template <typename U>
+    bool operator==(const MallocAllocator<U>&) const noexcept {
+        return true;
+    }
+
+private:
+    static void* Reallocate(void* p, size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        void* result = std::realloc(p, n * sizeof(T));
+        if (result == nullptr) {
+            throw std::bad_alloc();
+        }
+        return result;
+    }
+};
+
+// Размер кеш-линии, под который по умолчанию выравнивает AlignedAllocator
+inline constexpr size_t kCacheLineSize = 64;
+
+// Аллокатор, выравнивающий блоки по границе Alignment байт при помощи выравнивающих
+// operator new/delete. Блоки для SIMD-кода выравниваются по 32 или 64 байтам.
+// При PadToAlignment размер блока округляется вверх до кратного Alignment, а allocate_at_least
+// отдаёт всю эту память как вместимость: векторизованный цикл может обрабатывать хвост
+// целыми регистрами до Capacity(), не вызывая скалярный эпилог
+template <typename T, size_t Alignment = kCacheLineSize, bool PadToAlignment = true>
+class AlignedAllocator {
+    static_assert(std::has_single_bit(Alignment), "Alignment must be a power of two");
+    static_assert(Alignment >= alignof(T), "Alignment must not be weaker than alignof(T)");
+
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment, PadToAlignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment, PadToAlignment>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(BlockSize(n), std::align_val_t{Alignment}));
+    }
+
+    AllocationResult<T> allocate_at_least(size_t n) requires PadToAlignment {
+        return {allocate(n), BlockSize(n) / sizeof(T)};
+    }
+
+    void deallocate(T* p, size_t) noexcept {
+        ::operator delete(p, std::align_val_t{Alignment});
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment, PadToAlignment>&) const noexcept {
+        return true;
+    }
+
+private:
+    static size_t BlockSize(size_t n) {
+        if (n > (std::numeric_limits<size_t>::max() - Alignment) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        if constexpr (PadToAlignment) {
+            return (n * sizeof(T) + Alignment - 1) / Alignment * Alignment;
+        }
+        else {
+            return n * sizeof(T);
+        }
+    }
+};
@@ -0,0 +1,168 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+// Монотонная арена: выделение сдвигает указатель в текущем блоке, отдельные блоки памяти
+// не освобождаются, а всё выделенное освобождается разом в Release или деструкторе.
+// Блоки берутся у operator new и растут вдвое. Начальный блок можно передать снаружи,
+// например буфер на стеке обработчика запроса. Арена не потокобезопасна: она рассчитана
+// на один запрос в одном потоке и поэтому не конкурирует за общую кучу
+class MonotonicArena {
+public:
+    static constexpr size_t kDefaultBlockSize = 4096;
+
+    explicit MonotonicArena(size_t first_block_size = kDefaultBlockSize) noexcept
+        : next_block_size_(std::max(first_block_size, sizeof(BlockHeader) * 2)) {
+    }
+
+    // Сначала выделяет память из buffer. Буфер не освобождается и должен жить дольше арены
+    explicit MonotonicArena(std::span<std::byte> buffer) noexcept
+        : current_(buffer.data())
+        , end_(buffer.data() + buffer.size())
+        , initial_buffer_(buffer)
+        , next_block_size_(std::max(buffer.size() * 2, kDefaultBlockSize)) {
+    }
+
+    MonotonicArena(const MonotonicArena&) = delete;
+    MonotonicArena& operator=(const MonotonicArena&) = delete;
+
+    ~MonotonicArena() {
+        FreeBlocks();
+    }
+
+    // Выделяет bytes байт, выровненных по alignment
+    void* Allocate(size_t bytes, size_t alignment) {
+        assert(std::has_single_bit(alignment));
+        // Конец блока не обязан быть выровнен, поэтому отступ сравнивается с остатком блока
+        // до того, как указатель сдвигается: выровненный адрес может оказаться за end_
+        size_t padding = Padding(current_, alignment);
+        const auto available = static_cast<size_t>(end_ - current_);
+        if (current_ == nullptr || padding > available || bytes > available - padding) {
+            AddBlock(bytes, alignment);
+            padding = Padding(current_, alignment);
+        }
+        std::byte* p = current_ + padding;
+        current_ = p + bytes;
+        return p;
+    }
+
+    // Расширяет до new_bytes последний выделенный блок p размером old_bytes, если за ним
+    // хватает места в текущем блоке арены
+    bool Expand(void* p, size_t old_bytes, size_t new_bytes) noexcept {
+        auto* block = static_cast<std::byte*>(p);
+        if (block + old_bytes != current_ || new_bytes - old_bytes > static_cast<size_t>(end_ - current_)) {
+            return false;
+        }
+        current_ = block + new_bytes;
+        return true;
+    }
+
+    // Освобождает все блоки из кучи и снова начинает выделять с начального буфера
+    void Release() noexcept {
+        FreeBlocks();
+        current_ = initial_buffer_.data();
+        end_ = initial_buffer_.data() + initial_buffer_.size();
+    }
+
+private:
+    struct BlockHeader {
+        BlockHeader* previous;
+    };
+
+    // Число байт, на которое нужно сдвинуть p, чтобы он стал кратен alignment
+    static size_t Padding(const std::byte* p, size_t alignment) noexcept {
+        const auto address = reinterpret_cast<uintptr_t>(p);
+        return (alignment - address % alignment) % alignment;
+    }
+
+    void AddBlock(size_t bytes, size_t alignment) {
+        if (bytes > std::numeric_limits<size_t>::max() / 2 - alignment) {
+            throw std::bad_array_new_length();
+        }
+        // Запас в alignment байт покрывает отступ до выровненного адреса после заголовка
+        const size_t block_size = std::max(next_block_size_, sizeof(BlockHeader) + bytes + alignment);
+        auto* block = static_cast<std::byte*>(::operator new(block_size));
+        blocks_ = ::new (block) BlockHeader{blocks_};
+        current_ = block + sizeof(BlockHeader);
+        end_ = block + block_size;
+        next_block_size_ = std::max(next_block_size_, block_size) * 2;
+    }
+
+    void FreeBlocks() noexcept {
+        while (blocks_ != nullptr) {
+            ::operator delete(static_cast<void*>(std::exchange(blocks_, blocks_->previous)));
+        }
+    }
+
+    std::byte* current_ = nullptr;
+    std::byte* end_ = nullptr;
+    BlockHeader* blocks_ = nullptr;
+    std::span<std::byte> initial_buffer_;
+    size_t next_block_size_;
+};
+
+// Аллокатор поверх MonotonicArena. deallocate ничего не делает, а expand растит на месте
+// буфер, выделенный последним, поэтому Vector, растущий без других выделений между
+// вставками, не копирует элементы. Арена должна жить дольше всех контейнеров с этим аллокатором
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+    // Память арены доступна любому контейнеру, пока жива арена, поэтому буфер можно передать
+    // при перемещении и обмене, не копируя элементы
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    static constexpr bool kNoopDeallocate = true;
+
+    ArenaAllocator(MonotonicArena& arena) noexcept
+        : arena_(&arena) {
+    }
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) noexcept
+        : arena_(other.GetArena()) {
+    }
+
+    T* allocate(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(arena_->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) noexcept {
+    }
+
+    bool expand(T* p, size_t n, size_t new_n) noexcept {
+        return new_n <= std::numeric_limits<size_t>::max() / sizeof(T)
+            && arena_->Expand(p, n * sizeof(T), new_n * sizeof(T));
+    }
+
+    MonotonicArena* GetArena() const noexcept {
+        return arena_;
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const noexcept {
+        return arena_ == other.GetArena();
+    }
+
+private:
+    MonotonicArena* arena_;
+};
+
+// Вектор, выделяющий память в арене запроса: ArenaVector<T> v(arena)
+template <typename T, typename GrowthPolicy = DoublingGrowth>
+using ArenaVector = Vector<T, ArenaAllocator<T>, GrowthPolicy>;
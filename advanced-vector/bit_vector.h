@@ -0,0 +1,488 @@
+#pragma once
+#include "vector.h"
+#include "vector_algorithms.h"
+
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace vector_bits {
+
+inline constexpr size_t kWordBits = 64;
+
+inline constexpr size_t WordCount(size_t bits) noexcept {
+    return (bits + kWordBits - 1) / kWordBits;
+}
+
+struct AndOp {
+    template <typename V>
+    [[gnu::always_inline]] static void Apply(V& acc, const V& value) noexcept {
+        acc &= value;
+    }
+};
+
+struct OrOp {
+    template <typename V>
+    [[gnu::always_inline]] static void Apply(V& acc, const V& value) noexcept {
+        acc |= value;
+    }
+};
+
+struct XorOp {
+    template <typename V>
+    [[gnu::always_inline]] static void Apply(V& acc, const V& value) noexcept {
+        acc ^= value;
+    }
+};
+
+struct AndNotOp {
+    template <typename V>
+    [[gnu::always_inline]] static void Apply(V& acc, const V& value) noexcept {
+        acc &= ~value;
+    }
+};
+
+// dest[i] = Op(dest[i], src[i]) для слов двух битовых векторов
+template <typename Op>
+struct BitwiseKernel {
+    template <typename L, typename T>
+    [[gnu::always_inline]] static void Run(T* dest, const T* src, size_t n) noexcept {
+        dest = L::Assume(dest);
+        src = L::Assume(src);
+        typename L::Vec acc, value;
+        size_t i = 0;
+        for (; i + L::kCount <= n; i += L::kCount) {
+            L::Load(dest + i, acc);
+            L::Load(src + i, value);
+            Op::Apply(acc, value);
+            L::Store(dest + i, acc);
+        }
+        for (; i < n; ++i) {
+            Op::Apply(dest[i], src[i]);
+        }
+    }
+};
+
+// Четыре независимых счётчика, чтобы popcnt соседних слов выполнялись параллельно
+[[gnu::always_inline]] inline size_t PopcountLoop(const uint64_t* words, size_t n) noexcept {
+    size_t counts[4] = {};
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        counts[0] += __builtin_popcountll(words[i]);
+        counts[1] += __builtin_popcountll(words[i + 1]);
+        counts[2] += __builtin_popcountll(words[i + 2]);
+        counts[3] += __builtin_popcountll(words[i + 3]);
+    }
+    for (; i < n; ++i) {
+        counts[0] += __builtin_popcountll(words[i]);
+    }
+    return counts[0] + counts[1] + counts[2] + counts[3];
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+[[gnu::target("popcnt")]]
+#endif
+inline size_t PopcountPopcnt(const uint64_t* words, size_t n) noexcept {
+    return PopcountLoop(words, n);
+}
+
+// Число единичных битов в n словах. Базовый x86-64 не включает инструкцию popcnt, поэтому
+// она выбирается при первом вызове, если процессор её поддерживает
+inline size_t Popcount(const uint64_t* words, size_t n) noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    static const bool has_popcnt = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("popcnt") != 0;
+    }();
+    if (has_popcnt) {
+        return PopcountPopcnt(words, n);
+    }
+#endif
+    return PopcountLoop(words, n);
+}
+
+}  // namespace vector_bits
+
+// Вектор битов, упакованных по 64 в слово uint64_t, в 8 раз компактнее Vector<bool>.
+// Слова хранятся в Vector, поэтому рост и резервирование устроены так же, как у Vector
+// с тем же GrowthPolicy. Count, Find и побитовые операции обрабатывают слово (или регистр
+// SIMD из нескольких слов) за шаг. operator[] и итераторы возвращают прокси-ссылку Reference.
+// Биты последнего слова за пределами Size() всегда нулевые
+template <typename Alloc = std::allocator<uint64_t>, typename GrowthPolicy = DoublingGrowth>
+class BitVector {
+    using WordStorage = Vector<uint64_t, Alloc, GrowthPolicy>;
+
+    template <bool IsConst>
+    class BasicIterator;
+
+public:
+    class Reference;
+
+    using value_type = bool;
+    using reference = Reference;
+    using const_reference = bool;
+    using iterator = BasicIterator<false>;
+    using const_iterator = BasicIterator<true>;
+    using allocator_type = Alloc;
+
+    BitVector() = default;
+
+    explicit BitVector(const Alloc& alloc) noexcept
+        : words_(alloc) {
+    }
+
+    explicit BitVector(size_t size, bool value = false, const Alloc& alloc = Alloc())
+        : words_(vector_bits::WordCount(size), alloc)
+        , size_(size) {
+        if (value) {
+            Fill(true);
+        }
+    }
+
+    BitVector(const BitVector&) = default;
+
+    BitVector(BitVector&& other) noexcept
+        : words_(std::move(other.words_))
+        , size_(std::exchange(other.size_, 0)) {
+    }
+
+    BitVector& operator=(const BitVector&) = default;
+
+    BitVector& operator=(BitVector&& rhs) noexcept {
+        if (this != &rhs) {
+            words_ = std::move(rhs.words_);
+            size_ = std::exchange(rhs.size_, 0);
+        }
+        return *this;
+    }
+
+    void Swap(BitVector& other) noexcept {
+        words_.Swap(other.words_);
+        std::swap(size_, other.size_);
+    }
+
+    Alloc GetAllocator() const noexcept {
+        return words_.GetAllocator();
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return words_.Capacity() * vector_bits::kWordBits;
+    }
+
+    void Reserve(size_t new_capacity) {
+        words_.Reserve(vector_bits::WordCount(new_capacity));
+    }
+
+    // Новые биты равны value
+    void Resize(size_t new_size, bool value = false) {
+        if (new_size > size_ && value) {
+            // Слова добавляются до того, как хвост последнего слова меняется: если выделение
+            // памяти бросит исключение, хвост останется нулевым
+            const size_t old_words = words_.Size();
+            words_.ResizeDefaultInit(vector_bits::WordCount(new_size));
+            std::fill(words_.begin() + old_words, words_.end(), ~uint64_t{0});
+            // Хвост последнего слова уже нулевой, его достаточно дополнить единицами
+            if (size_ % vector_bits::kWordBits != 0) {
+                words_[size_ / vector_bits::kWordBits] |= ~uint64_t{0} << (size_ % vector_bits::kWordBits);
+            }
+        }
+        else {
+            words_.Resize(vector_bits::WordCount(new_size));
+        }
+        size_ = new_size;
+        ClearTail();
+    }
+
+    void ShrinkToFit() {
+        words_.ShrinkToFit();
+    }
+
+    void Clear() noexcept {
+        words_.Clear();
+        size_ = 0;
+    }
+
+    bool operator[](size_t index) const noexcept {
+        ADVANCED_VECTOR_CHECK(index < size_);
+        return (words_[index / vector_bits::kWordBits] >> (index % vector_bits::kWordBits)) & 1;
+    }
+
+    Reference operator[](size_t index) noexcept {
+        ADVANCED_VECTOR_CHECK(index < size_);
+        return {words_.Data() + index / vector_bits::kWordBits, uint64_t{1} << (index % vector_bits::kWordBits)};
+    }
+
+    void PushBack(bool value) {
+        if (size_ % vector_bits::kWordBits == 0) {
+            words_.PushBack(0);
+        }
+        words_[size_ / vector_bits::kWordBits] |= uint64_t{value} << (size_ % vector_bits::kWordBits);
+        ++size_;
+    }
+
+    void PopBack() noexcept {
+        ADVANCED_VECTOR_CHECK(size_ > 0);
+        --size_;
+        if (size_ % vector_bits::kWordBits == 0) {
+            words_.PopBack();
+        }
+        else {
+            ClearTail();
+        }
+    }
+
+    // Присваивает value всем битам
+    void Fill(bool value) noexcept {
+        ::Fill(words_, value ? ~uint64_t{0} : uint64_t{0});
+        ClearTail();
+    }
+
+    // Инвертирует все биты
+    void Flip() noexcept {
+        ::TransformLanes(words_, [](auto word) {
+            return ~word;
+        });
+        ClearTail();
+    }
+
+    // Число битов, равных value
+    size_t Count(bool value = true) const noexcept {
+        const size_t ones = vector_bits::Popcount(words_.Data(), words_.Size());
+        return value ? ones : size_ - ones;
+    }
+
+    // Индекс первого бита, равного value, начиная с first, или Size()
+    size_t Find(bool value, size_t first = 0) const noexcept {
+        if (first >= size_) {
+            return size_;
+        }
+        const uint64_t invert = value ? 0 : ~uint64_t{0};
+        size_t index = first / vector_bits::kWordBits;
+        uint64_t word = (words_[index] ^ invert) & (~uint64_t{0} << (first % vector_bits::kWordBits));
+        while (word == 0) {
+            if (++index == words_.Size()) {
+                return size_;
+            }
+            word = words_[index] ^ invert;
+        }
+        // Инвертированный хвост последнего слова состоит из единиц, поэтому результат ограничивается Size()
+        return std::min(index * vector_bits::kWordBits + std::countr_zero(word), size_);
+    }
+
+    // Побитовые операции с вектором того же размера
+    BitVector& operator&=(const BitVector& rhs) noexcept {
+        return Apply<vector_bits::AndOp>(rhs);
+    }
+
+    BitVector& operator|=(const BitVector& rhs) noexcept {
+        return Apply<vector_bits::OrOp>(rhs);
+    }
+
+    BitVector& operator^=(const BitVector& rhs) noexcept {
+        return Apply<vector_bits::XorOp>(rhs);
+    }
+
+    // Сбрасывает биты, установленные в rhs
+    BitVector& AndNot(const BitVector& rhs) noexcept {
+        return Apply<vector_bits::AndNotOp>(rhs);
+    }
+
+    friend BitVector operator&(BitVector lhs, const BitVector& rhs) noexcept {
+        return lhs &= rhs;
+    }
+
+    friend BitVector operator|(BitVector lhs, const BitVector& rhs) noexcept {
+        return lhs |= rhs;
+    }
+
+    friend BitVector operator^(BitVector lhs, const BitVector& rhs) noexcept {
+        return lhs ^= rhs;
+    }
+
+    // Слова с битами: бит i лежит в слове i / 64 на позиции i % 64
+    std::span<const uint64_t> Words() const noexcept {
+        return {words_.Data(), words_.Size()};
+    }
+
+    iterator begin() noexcept {
+        return {this, 0};
+    }
+
+    iterator end() noexcept {
+        return {this, size_};
+    }
+
+    const_iterator begin() const noexcept {
+        return {this, 0};
+    }
+
+    const_iterator end() const noexcept {
+        return {this, size_};
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    friend bool operator==(const BitVector& lhs, const BitVector& rhs) {
+        return lhs.size_ == rhs.size_ && lhs.words_ == rhs.words_;
+    }
+
+private:
+    template <typename Op>
+    BitVector& Apply(const BitVector& rhs) noexcept {
+        ADVANCED_VECTOR_CHECK(size_ == rhs.size_);
+        using Traits = vector_simd::VectorTraits<WordStorage>;
+        vector_simd::Run<vector_bits::BitwiseKernel<Op>, uint64_t, Traits::kAlignment>(words_.Data(), rhs.words_.Data(),
+                                                                                        words_.Size());
+        return *this;
+    }
+
+    // Обнуляет биты последнего слова за пределами Size()
+    void ClearTail() noexcept {
+        if (size_ % vector_bits::kWordBits != 0) {
+            words_[words_.Size() - 1] &= ~(~uint64_t{0} << (size_ % vector_bits::kWordBits));
+        }
+    }
+
+    WordStorage words_;
+    size_t size_ = 0;
+};
+
+// Прокси-ссылка на бит
+template <typename Alloc, typename GrowthPolicy>
+class BitVector<Alloc, GrowthPolicy>::Reference {
+public:
+    Reference& operator=(bool value) noexcept {
+        *word_ = value ? *word_ | mask_ : *word_ & ~mask_;
+        return *this;
+    }
+
+    Reference& operator=(const Reference& other) noexcept {
+        return *this = static_cast<bool>(other);
+    }
+
+    operator bool() const noexcept {
+        return (*word_ & mask_) != 0;
+    }
+
+    void Flip() noexcept {
+        *word_ ^= mask_;
+    }
+
+private:
+    friend class BitVector;
+
+    Reference(uint64_t* word, uint64_t mask) noexcept
+        : word_(word)
+        , mask_(mask) {
+    }
+
+    uint64_t* word_;
+    uint64_t mask_;
+};
+
+// Итератор произвольного доступа по индексу бита. Разыменование даёт Reference,
+// поэтому по стандарту он считается лишь итератором ввода
+template <typename Alloc, typename GrowthPolicy>
+template <bool IsConst>
+class BitVector<Alloc, GrowthPolicy>::BasicIterator {
+    using Owner = std::conditional_t<IsConst, const BitVector, BitVector>;
+
+public:
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = bool;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::conditional_t<IsConst, bool, Reference>;
+
+    BasicIterator() = default;
+
+    BasicIterator(Owner* owner, size_t index) noexcept
+        : owner_(owner)
+        , index_(index) {
+    }
+
+    operator BasicIterator<true>() const noexcept requires(!IsConst) {
+        return {owner_, index_};
+    }
+
+    reference operator*() const noexcept {
+        return (*owner_)[index_];
+    }
+
+    reference operator[](difference_type offset) const noexcept {
+        return (*owner_)[index_ + offset];
+    }
+
+    BasicIterator& operator++() noexcept {
+        ++index_;
+        return *this;
+    }
+
+    BasicIterator operator++(int) noexcept {
+        return {owner_, index_++};
+    }
+
+    BasicIterator& operator--() noexcept {
+        --index_;
+        return *this;
+    }
+
+    BasicIterator operator--(int) noexcept {
+        return {owner_, index_--};
+    }
+
+    BasicIterator& operator+=(difference_type offset) noexcept {
+        index_ += offset;
+        return *this;
+    }
+
+    BasicIterator& operator-=(difference_type offset) noexcept {
+        index_ -= offset;
+        return *this;
+    }
+
+    friend BasicIterator operator+(BasicIterator it, difference_type offset) noexcept {
+        return it += offset;
+    }
+
+    friend BasicIterator operator+(difference_type offset, BasicIterator it) noexcept {
+        return it += offset;
+    }
+
+    friend BasicIterator operator-(BasicIterator it, difference_type offset) noexcept {
+        return it -= offset;
+    }
+
+    friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+        return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+    }
+
+    friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+        return lhs.index_ == rhs.index_;
+    }
+
+    friend auto operator<=>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+        return lhs.index_ <=> rhs.index_;
+    }
+
+private:
+    Owner* owner_ = nullptr;
+    size_t index_ = 0;
+};
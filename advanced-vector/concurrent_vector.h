@@ -0,0 +1,240 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+// Вектор, в который несколько потоков добавляют элементы без блокировок. Элементы хранятся
+// в сегментах, размеры которых растут степенями двойки: сегмент k вмещает kFirstSegmentSize << k
+// элементов. Сегменты никогда не перемещаются, поэтому ссылки на элементы остаются валидными
+// до Clear или разрушения вектора.
+//
+// EmplaceBack резервирует индекс атомарным счётчиком, при необходимости выделяет сегмент
+// (проигравший гонку поток возвращает свой блок) и публикует элемент флагом слота.
+// Чтение опубликованного элемента через operator[] не ждёт других потоков. Size() считает
+// зарезервированные индексы, поэтому элемент с индексом меньше Size() может быть ещё не
+// опубликован: его готовность проверяет IsPublished. Clear, как и разрушение, не должен
+// выполняться одновременно с другими операциями
+template <typename T, typename Alloc = std::allocator<T>>
+class ConcurrentVector {
+    static constexpr size_t kFirstSegmentSize = 32;
+    static constexpr size_t kFirstSegmentLog = std::countr_zero(kFirstSegmentSize);
+    static constexpr size_t kMaxSegments = 64 - kFirstSegmentLog;
+
+    // Состояние слота: ещё не построен, опубликован или конструктор элемента бросил исключение
+    enum class SlotState : uint8_t {
+        kEmpty,
+        kPublished,
+        kFailed,
+    };
+
+    struct Slot {
+        T* Get() noexcept {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+
+        alignas(T) std::byte storage[sizeof(T)];
+        std::atomic<SlotState> state{SlotState::kEmpty};
+    };
+
+    using SlotAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Slot>;
+    using SlotAllocTraits = std::allocator_traits<SlotAlloc>;
+
+public:
+    using value_type = T;
+    using allocator_type = Alloc;
+
+    ConcurrentVector() = default;
+
+    explicit ConcurrentVector(const Alloc& alloc) noexcept
+        : alloc_(alloc) {
+    }
+
+    ConcurrentVector(const ConcurrentVector&) = delete;
+    ConcurrentVector& operator=(const ConcurrentVector&) = delete;
+
+    ~ConcurrentVector() {
+        Clear();
+        for (size_t k = 0; k < kMaxSegments; ++k) {
+            if (Slot* segment = segments_[k].load(std::memory_order_relaxed)) {
+                DeallocateSegment(segment, k);
+            }
+        }
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        const size_t index = size_.fetch_add(1, std::memory_order_relaxed);
+        if (index >= MaxSize()) {
+            throw std::length_error("ConcurrentVector is full");
+        }
+        const auto [segment, offset] = Locate(index);
+        Slot& slot = EnsureSegment(segment)[offset];
+        try {
+            std::construct_at(slot.Get(), std::forward<Args>(args)...);
+        }
+        catch (...) {
+            slot.state.store(SlotState::kFailed, std::memory_order_relaxed);
+            throw;
+        }
+        slot.state.store(SlotState::kPublished, std::memory_order_release);
+        return *slot.Get();
+    }
+
+    T& PushBack(const T& value) {
+        return EmplaceBack(value);
+    }
+
+    T& PushBack(T&& value) {
+        return EmplaceBack(std::move(value));
+    }
+
+    // Заранее выделяет сегменты под первые capacity элементов. Безопасен при параллельных вставках
+    void Reserve(size_t capacity) {
+        if (capacity == 0) {
+            return;
+        }
+        const size_t last_segment = Locate(std::min(capacity, MaxSize()) - 1).first;
+        for (size_t k = 0; k <= last_segment; ++k) {
+            EnsureSegment(k);
+        }
+    }
+
+    // Число зарезервированных индексов, включая ещё не опубликованные элементы
+    size_t Size() const noexcept {
+        return std::min(size_.load(std::memory_order_acquire), MaxSize());
+    }
+
+    // Суммарная вместимость выделенных подряд с начала сегментов
+    size_t Capacity() const noexcept {
+        size_t k = 0;
+        while (k < kMaxSegments && segments_[k].load(std::memory_order_acquire) != nullptr) {
+            ++k;
+        }
+        return SegmentBegin(k);
+    }
+
+    // Элемент index построен, и его можно читать: после true запись элемента видна
+    // вызывающему потоку
+    bool IsPublished(size_t index) const noexcept {
+        if (index >= Size()) {
+            return false;
+        }
+        const auto [segment, offset] = Locate(index);
+        const Slot* slots = segments_[segment].load(std::memory_order_acquire);
+        return slots != nullptr && slots[offset].state.load(std::memory_order_acquire) == SlotState::kPublished;
+    }
+
+    // Элемент index должен быть опубликован и виден вызывающему потоку: через IsPublished,
+    // ссылку из EmplaceBack или внешнюю синхронизацию
+    T& operator[](size_t index) noexcept {
+        const auto [segment, offset] = Locate(index);
+        Slot* slots = segments_[segment].load(std::memory_order_acquire);
+        assert(slots != nullptr && slots[offset].state.load(std::memory_order_relaxed) == SlotState::kPublished);
+        return *slots[offset].Get();
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<ConcurrentVector&>(*this)[index];
+    }
+
+    // Вызывает f(index, element) для опубликованных элементов с индексами меньше Size()
+    template <typename Function>
+    void ForEachPublished(Function f) const {
+        const size_t size = Size();
+        for (size_t k = 0; k < kMaxSegments && SegmentBegin(k) < size; ++k) {
+            Slot* slots = segments_[k].load(std::memory_order_acquire);
+            if (slots == nullptr) {
+                continue;
+            }
+            const size_t count = std::min(SegmentSize(k), size - SegmentBegin(k));
+            for (size_t i = 0; i < count; ++i) {
+                if (slots[i].state.load(std::memory_order_acquire) == SlotState::kPublished) {
+                    f(SegmentBegin(k) + i, std::as_const(*slots[i].Get()));
+                }
+            }
+        }
+    }
+
+    // Разрушает все элементы, сохраняя сегменты. Не потокобезопасен
+    void Clear() noexcept {
+        const size_t size = Size();
+        for (size_t k = 0; k < kMaxSegments && SegmentBegin(k) < size; ++k) {
+            Slot* slots = segments_[k].load(std::memory_order_relaxed);
+            if (slots == nullptr) {
+                continue;
+            }
+            const size_t count = std::min(SegmentSize(k), size - SegmentBegin(k));
+            for (size_t i = 0; i < count; ++i) {
+                if (slots[i].state.load(std::memory_order_relaxed) == SlotState::kPublished) {
+                    std::destroy_at(slots[i].Get());
+                }
+                slots[i].state.store(SlotState::kEmpty, std::memory_order_relaxed);
+            }
+        }
+        size_.store(0, std::memory_order_relaxed);
+    }
+
+    Alloc GetAllocator() const noexcept {
+        return Alloc(alloc_);
+    }
+
+private:
+    static constexpr size_t MaxSize() noexcept {
+        return SegmentBegin(kMaxSegments - 1);
+    }
+
+    static constexpr size_t SegmentSize(size_t segment) noexcept {
+        return kFirstSegmentSize << segment;
+    }
+
+    // Индекс первого элемента сегмента: kFirstSegmentSize * (2^segment - 1)
+    static constexpr size_t SegmentBegin(size_t segment) noexcept {
+        return (kFirstSegmentSize << segment) - kFirstSegmentSize;
+    }
+
+    // Номер сегмента и смещение в нём для элемента index
+    static std::pair<size_t, size_t> Locate(size_t index) noexcept {
+        const size_t biased = index + kFirstSegmentSize;
+        const size_t segment = std::bit_width(biased) - 1 - kFirstSegmentLog;
+        return {segment, biased - (kFirstSegmentSize << segment)};
+    }
+
+    // Возвращает сегмент, выделяя его при первом обращении. Из нескольких потоков,
+    // выделивших сегмент одновременно, его устанавливает один, остальные освобождают свои блоки
+    Slot* EnsureSegment(size_t segment) {
+        Slot* slots = segments_[segment].load(std::memory_order_acquire);
+        if (slots != nullptr) {
+            return slots;
+        }
+        Slot* fresh = AllocateSegment(segment);
+        if (segments_[segment].compare_exchange_strong(slots, fresh, std::memory_order_acq_rel,
+                                                       std::memory_order_acquire)) {
+            return fresh;
+        }
+        DeallocateSegment(fresh, segment);
+        return slots;
+    }
+
+    Slot* AllocateSegment(size_t segment) {
+        const size_t n = SegmentSize(segment);
+        Slot* slots = SlotAllocTraits::allocate(alloc_, n);
+        std::uninitialized_default_construct_n(slots, n);
+        return slots;
+    }
+
+    void DeallocateSegment(Slot* slots, size_t segment) noexcept {
+        std::destroy_n(slots, SegmentSize(segment));
+        SlotAllocTraits::deallocate(alloc_, slots, SegmentSize(segment));
+    }
+
+    std::atomic<Slot*> segments_[kMaxSegments] = {};
+    std::atomic<size_t> size_ = 0;
+    [[no_unique_address]] SlotAlloc alloc_;
+};
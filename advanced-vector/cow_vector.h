@@ -0,0 +1,302 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <utility>
+
+// Вектор с копированием при записи. Элементы лежат в общем блоке со счётчиком ссылок,
+// поэтому копирование CowVector стоит O(1) и не трогает элементы. Первый изменяющий вызов
+// копирует элементы в собственный блок, если блок разделён с другими копиями. Счётчик
+// атомарный: копии можно передавать в другие потоки и читать там без блокировок.
+// Один объект CowVector, как и Vector, нельзя изменять из нескольких потоков одновременно.
+// Ссылки и указатели, полученные из неконстантных методов, годятся для записи только до
+// следующего копирования вектора: после него блок снова разделён
+template <typename T, typename Alloc = std::allocator<T>, typename GrowthPolicy = DoublingGrowth>
+class CowVector {
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using allocator_type = Alloc;
+    using Elements = Vector<T, Alloc, GrowthPolicy>;
+
+    CowVector() = default;
+
+    explicit CowVector(const Alloc& alloc) noexcept
+        : alloc_(alloc) {
+    }
+
+    // Забирает элементы без копирования
+    explicit CowVector(Elements elements)
+        : alloc_(elements.GetAllocator()) {
+        block_ = CreateBlock(std::move(elements));
+    }
+
+    CowVector(const CowVector& other) noexcept
+        : block_(other.block_)
+        , alloc_(other.alloc_) {
+        if (block_ != nullptr) {
+            // Новая ссылка появляется от уже существующей, поэтому упорядочивать нечего
+            block_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    CowVector(CowVector&& other) noexcept
+        : block_(std::exchange(other.block_, nullptr))
+        , alloc_(other.alloc_) {
+    }
+
+    ~CowVector() {
+        ReleaseBlock();
+    }
+
+    CowVector& operator=(const CowVector& rhs) noexcept {
+        if (this != &rhs) {
+            CowVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    CowVector& operator=(CowVector&& rhs) noexcept {
+        if (this != &rhs) {
+            ReleaseBlock();
+            block_ = std::exchange(rhs.block_, nullptr);
+            alloc_ = rhs.alloc_;
+        }
+        return *this;
+    }
+
+    void Swap(CowVector& other) noexcept {
+        std::swap(block_, other.block_);
+        using std::swap;
+        swap(alloc_, other.alloc_);
+    }
+
+    Alloc GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    size_t Size() const noexcept {
+        return block_ == nullptr ? 0 : block_->elements.Size();
+    }
+
+    // Число копий, разделяющих блок (0 у пустого вектора без блока)
+    size_t UseCount() const noexcept {
+        return block_ == nullptr ? 0 : block_->refs.load(std::memory_order_relaxed);
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < Size());
+        return block_->elements[index];
+    }
+
+    // Отделяет блок, если он разделён
+    T& operator[](size_t index) {
+        assert(index < Size());
+        return Detach()[index];
+    }
+
+    std::span<const T> View() const noexcept {
+        return {begin(), Size()};
+    }
+
+    // Отделяет блок, если он разделён, и даёт доступ ко всем операциям Vector
+    Elements& Mutable() {
+        return Detach();
+    }
+
+    // Аргументы могут ссылаться на элементы разделённого блока: он остаётся живым,
+    // пока новый элемент не построен, даже если другие копии тем временем его отпустят
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        // При отделении сразу выделяется место под следующий элемент, чтобы не копировать дважды
+        const size_t size = Size();
+        HeldBlock old_block(*this);
+        return Detach(GrowthPolicy::NextCapacity(size, size + 1, sizeof(T)), old_block)
+            .EmplaceBack(std::forward<Args>(args)...);
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    void PopBack() {
+        assert(Size() > 0);
+        Detach().PopBack();
+    }
+
+    iterator Insert(const_iterator pos, const T& value) {
+        const size_t index = pos - begin();
+        HeldBlock old_block(*this);
+        Elements& elements = Detach(Size() + 1, old_block);
+        elements.Insert(elements.begin() + index, value);
+        return elements.Data() + index;
+    }
+
+    iterator Insert(const_iterator pos, T&& value) {
+        const size_t index = pos - begin();
+        HeldBlock old_block(*this);
+        Elements& elements = Detach(Size() + 1, old_block);
+        elements.Insert(elements.begin() + index, std::move(value));
+        return elements.Data() + index;
+    }
+
+    iterator Erase(const_iterator pos) {
+        const size_t index = pos - begin();
+        Elements& elements = Detach();
+        elements.Erase(elements.begin() + index);
+        return elements.Data() + index;
+    }
+
+    iterator Erase(const_iterator first, const_iterator last) {
+        const size_t index = first - begin();
+        const size_t count = last - first;
+        Elements& elements = Detach();
+        elements.Erase(elements.begin() + index, elements.begin() + index + count);
+        return elements.Data() + index;
+    }
+
+    void Resize(size_t new_size) {
+        Detach(new_size).Resize(new_size);
+    }
+
+    void Reserve(size_t new_capacity) {
+        Detach(new_capacity).Reserve(new_capacity);
+    }
+
+    // Разделённый блок не копируется, а просто отпускается
+    void Clear() noexcept {
+        if (block_ != nullptr && block_->refs.load(std::memory_order_acquire) == 1) {
+            block_->elements.Clear();
+        }
+        else {
+            ReleaseBlock();
+        }
+    }
+
+    const_iterator begin() const noexcept {
+        return block_ == nullptr ? nullptr : block_->elements.Data();
+    }
+
+    const_iterator end() const noexcept {
+        return block_ == nullptr ? nullptr : block_->elements.Data() + Size();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    friend bool operator==(const CowVector& lhs, const CowVector& rhs) {
+        return lhs.block_ == rhs.block_ || std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+private:
+    struct Block {
+        template <typename... Args>
+        explicit Block(Args&&... args)
+            : elements(std::forward<Args>(args)...) {
+        }
+
+        std::atomic<size_t> refs = 1;
+        Elements elements;
+    };
+
+    using BlockAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Block>;
+    using BlockAllocTraits = std::allocator_traits<BlockAlloc>;
+
+    template <typename... Args>
+    Block* CreateBlock(Args&&... args) {
+        BlockAlloc block_alloc(alloc_);
+        Block* block = BlockAllocTraits::allocate(block_alloc, 1);
+        try {
+            return std::construct_at(block, std::forward<Args>(args)...);
+        }
+        catch (...) {
+            BlockAllocTraits::deallocate(block_alloc, block, 1);
+            throw;
+        }
+    }
+
+    void DestroyBlock(Block* block) noexcept {
+        BlockAlloc block_alloc(alloc_);
+        std::destroy_at(block);
+        BlockAllocTraits::deallocate(block_alloc, block, 1);
+    }
+
+    // Последняя копия разрушает блок. acq_rel упорядочивает чтения блока в других копиях
+    // до их отпускания раньше разрушения
+    void ReleaseBlock(Block* block) noexcept {
+        if (block != nullptr && block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            DestroyBlock(block);
+        }
+    }
+
+    void ReleaseBlock() noexcept {
+        ReleaseBlock(std::exchange(block_, nullptr));
+    }
+
+    // Ссылка на блок, от которого вектор отделился в Detach. Отпускается при выходе из области,
+    // то есть после того, как изменяющая операция закончила читать свои аргументы
+    class HeldBlock {
+    public:
+        explicit HeldBlock(CowVector& owner) noexcept
+            : owner_(owner) {
+        }
+
+        HeldBlock(const HeldBlock&) = delete;
+        HeldBlock& operator=(const HeldBlock&) = delete;
+
+        ~HeldBlock() {
+            owner_.ReleaseBlock(block_);
+        }
+
+    private:
+        friend class CowVector;
+
+        CowVector& owner_;
+        Block* block_ = nullptr;
+    };
+
+    Elements& Detach(size_t capacity = 0) {
+        HeldBlock old_block(*this);
+        return Detach(capacity, old_block);
+    }
+
+    // Делает блок собственным. Разделённый блок копируется в новый вместимостью не меньше capacity,
+    // а ссылка на прежний блок переходит к old_block
+    Elements& Detach(size_t capacity, HeldBlock& old_block) {
+        if (block_ == nullptr) {
+            block_ = CreateBlock(alloc_);
+        }
+        else if (block_->refs.load(std::memory_order_acquire) != 1) {
+            Block* copy = CreateBlock(alloc_);
+            try {
+                copy->elements.Reserve(std::max(capacity, Size()));
+                copy->elements.Append(block_->elements);
+            }
+            catch (...) {
+                DestroyBlock(copy);
+                throw;
+            }
+            old_block.block_ = std::exchange(block_, copy);
+        }
+        return block_->elements;
+    }
+
+    Block* block_ = nullptr;
+    [[no_unique_address]] Alloc alloc_;
+};
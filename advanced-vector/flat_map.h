@@ -0,0 +1,854 @@
+#pragma once
+#include "allocators.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Тег конструкторов и InsertRange у FlatSet и FlatMap, которые принимают ключи, уже
+// упорядоченные по возрастанию и без повторов. Порядок тогда не проверяется и не восстанавливается
+struct SortedUniqueTag {
+    explicit SortedUniqueTag() = default;
+};
+
+inline constexpr SortedUniqueTag sorted_unique{};
+
+namespace flat_container {
+
+template <typename Keys, typename Compare>
+bool IsSortedUnique(const Keys& keys, const Compare& comp) {
+    return std::adjacent_find(keys.begin(), keys.end(), [&](const auto& lhs, const auto& rhs) {
+               return !comp(lhs, rhs);
+           }) == keys.end();
+}
+
+// Упорядочивает ключи и оставляет первый из равных
+template <typename Keys, typename Compare>
+void SortUnique(Keys& keys, const Compare& comp) {
+    if (IsSortedUnique(keys, comp)) {
+        return;
+    }
+    std::stable_sort(keys.begin(), keys.end(), comp);
+    const auto last = std::unique(keys.begin(), keys.end(), [&](const auto& lhs, const auto& rhs) {
+        return !comp(lhs, rhs);
+    });
+    keys.Erase(last, keys.end());
+}
+
+// Ключей и значений, из которых собирается FlatMap, должно быть поровну
+template <typename Keys, typename Values>
+void CheckSameSize(const Keys& keys, const Values& values) {
+    if (keys.Size() != values.Size()) {
+        throw std::invalid_argument("FlatMap key and value containers differ in size");
+    }
+}
+
+// Упорядочивает ключи вместе с соответствующими значениями и оставляет первую из пар с
+// равными ключами. Переставляются индексы, а каждая пара переносится один раз
+template <typename Keys, typename Values, typename Compare>
+void SortUniqueByKey(Keys& keys, Values& values, const Compare& comp) {
+    assert(keys.Size() == values.Size());
+    if (IsSortedUnique(keys, comp)) {
+        return;
+    }
+    const size_t size = keys.Size();
+    Vector<size_t> order(size, default_init);
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+        return comp(keys[lhs], keys[rhs]);
+    });
+    Keys sorted_keys(keys.GetAllocator());
+    Values sorted_values(values.GetAllocator());
+    sorted_keys.Reserve(size);
+    sorted_values.Reserve(size);
+    for (const size_t index : order) {
+        if (sorted_keys.Size() != 0 && !comp(sorted_keys[sorted_keys.Size() - 1], keys[index])) {
+            continue;
+        }
+        sorted_keys.EmplaceBack(std::move(keys[index]));
+        sorted_values.EmplaceBack(std::move(values[index]));
+    }
+    keys = std::move(sorted_keys);
+    values = std::move(sorted_values);
+}
+
+// Индекс первого ключа, не меньшего key, или keys.size()
+template <typename Key, typename Compare>
+size_t BranchlessLowerBound(std::span<const Key> keys, const Key& key, const Compare& comp) {
+    if (keys.empty()) {
+        return 0;
+    }
+    const Key* base = keys.data();
+    size_t size = keys.size();
+    while (size > 1) {
+        const size_t half = size / 2;
+        // Обе половины вычисляются без перехода, и компилятор выбирает их условной пересылкой
+        base = comp(base[half], key) ? base + half : base;
+        size -= half;
+    }
+    return static_cast<size_t>(base - keys.data()) + static_cast<size_t>(comp(*base, key));
+}
+
+}  // namespace flat_container
+
+// Двоичный поиск без ветвлений по самому массиву ключей. Число шагов зависит только от
+// размера таблицы, поэтому предсказатель переходов не ошибается. Дополнительной памяти не требует
+struct BranchlessLookup {
+    template <typename Key>
+    class Index {
+    public:
+        void Build(std::span<const Key> /*keys*/) noexcept {
+        }
+
+        template <typename Compare>
+        size_t LowerBound(std::span<const Key> keys, const Key& key, const Compare& comp) const {
+            return flat_container::BranchlessLowerBound(keys, key, comp);
+        }
+
+        // Индекс ключа, равного key, или keys.size()
+        template <typename Compare>
+        size_t Find(std::span<const Key> keys, const Key& key, const Compare& comp) const {
+            const size_t index = LowerBound(keys, key, comp);
+            return index != keys.size() && !comp(key, keys[index]) ? index : keys.size();
+        }
+    };
+};
+
+// Поиск по копии ключей в порядке Эйтцингера, то есть дерева поиска, записанного по уровням.
+// Верхние уровни дерева занимают несколько кеш-линий и не вытесняются, а потомки узла на
+// четыре уровня ниже лежат подряд и подгружаются заранее. Окупается на таблицах, которые не
+// помещаются в кеш, но хранит копию ключей и перестраивается за O(n) при каждом изменении
+// контейнера. Подходит для таблиц, которые строятся один раз и много раз читаются
+struct EytzingerLookup {
+    template <typename Key>
+    class Index {
+        static_assert(std::is_copy_constructible_v<Key>, "EytzingerLookup keeps a copy of the keys");
+
+    public:
+        void Build(std::span<const Key> keys) {
+            tree_.Clear();
+            if (keys.empty()) {
+                return;
+            }
+            // Узлы нумеруются с 1, чтобы потомки узла k были 2k и 2k + 1. Нулевой элемент
+            // не используется и лишь занимает место
+            tree_.Reserve(keys.size() + 1);
+            tree_.PushBack(keys[0]);
+            for (size_t node = 1; node <= keys.size(); ++node) {
+                tree_.PushBack(keys[Rank(node, keys.size())]);
+            }
+        }
+
+        template <typename Compare>
+        size_t LowerBound(std::span<const Key> keys, const Key& key, const Compare& comp) const {
+            const size_t node = LowerBoundNode(keys.size(), key, comp);
+            return node == 0 ? keys.size() : Rank(node, keys.size());
+        }
+
+        // Найденный ключ сравнивается с копией в дереве, которая уже в кеше
+        template <typename Compare>
+        size_t Find(std::span<const Key> keys, const Key& key, const Compare& comp) const {
+            const size_t node = LowerBoundNode(keys.size(), key, comp);
+            return node == 0 || comp(key, tree_[node]) ? keys.size() : Rank(node, keys.size());
+        }
+
+    private:
+        // Потомки узла на четыре уровня ниже
+        static constexpr size_t kPrefetchDistance = 16;
+
+        // Номер узла с первым ключом не меньше key или 0
+        template <typename Compare>
+        size_t LowerBoundNode(size_t size, const Key& key, const Compare& comp) const {
+            assert(size == 0 ? tree_.Size() == 0 : tree_.Size() == size + 1);
+            const Key* tree = tree_.Data();
+            size_t node = 1;
+            while (node <= size) {
+                __builtin_prefetch(tree + std::min(node * kPrefetchDistance, size));
+                node = 2 * node + static_cast<size_t>(comp(tree[node], key));
+            }
+            // Младшие единицы - повороты направо после последнего поворота налево. Узел, где
+            // поиск последний раз свернул налево, и хранит первый ключ не меньше key
+            return node >> (std::countr_one(node) + 1);
+        }
+
+        // Индекс в упорядоченном массиве ключа из узла node дерева из size узлов. Считается
+        // по номеру узла без отдельной таблицы, чтобы поиск не читал лишнюю кеш-линию
+        static size_t Rank(size_t node, size_t size) noexcept {
+            const int levels = std::bit_width(size);
+            const int depth = std::bit_width(node) - 1;
+            // Позиция узла при симметричном обходе полного дерева из levels уровней
+            const size_t rank = ((2 * (node - (size_t{1} << depth)) + 1) << (levels - 1 - depth)) - 1;
+            // Листья нижнего уровня занимают чётные позиции, и недостающие листья лежат правее
+            // имеющихся. Из позиции вычитается число недостающих листьев левее узла
+            const size_t leaves = size - ((size_t{1} << (levels - 1)) - 1);
+            return rank < 2 * leaves ? rank : rank - (rank - 2 * leaves + 1) / 2;
+        }
+
+        Vector<Key, AlignedAllocator<Key>> tree_;
+    };
+};
+
+// Множество на отсортированном Vector ключей. Поиск идёт по непрерывному массиву и обходится
+// без переходов по указателям, поэтому для небольших и средних таблиц он в разы быстрее std::set.
+// Вставка и удаление сдвигают хвост массива за O(n). Много ключей лучше добавлять разом:
+// конструктор упорядочивает их одной сортировкой, а InsertRange вливает за один проход слияния.
+// Lookup выбирает способ поиска (BranchlessLookup или EytzingerLookup)
+template <typename Key, typename Compare = std::less<Key>, typename Lookup = BranchlessLookup,
+          typename KeyContainer = Vector<Key>>
+class FlatSet {
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using key_compare = Compare;
+    using container_type = KeyContainer;
+    using iterator = const Key*;
+    using const_iterator = const Key*;
+
+    FlatSet() = default;
+
+    explicit FlatSet(const Compare& comp)
+        : comp_(comp) {
+    }
+
+    // Упорядочивает keys и удаляет повторы, оставляя первый из равных ключей
+    explicit FlatSet(KeyContainer keys, const Compare& comp = Compare())
+        : keys_(std::move(keys))
+        , comp_(comp) {
+        flat_container::SortUnique(keys_, comp_);
+        index_.Build(Keys());
+    }
+
+    FlatSet(SortedUniqueTag, KeyContainer keys, const Compare& comp = Compare())
+        : keys_(std::move(keys))
+        , comp_(comp) {
+        assert(flat_container::IsSortedUnique(keys_, comp_));
+        index_.Build(Keys());
+    }
+
+    FlatSet(std::initializer_list<Key> keys, const Compare& comp = Compare())
+        : comp_(comp) {
+        keys_.Append(keys);
+        flat_container::SortUnique(keys_, comp_);
+        index_.Build(Keys());
+    }
+
+    size_t Size() const noexcept {
+        return keys_.Size();
+    }
+
+    std::span<const Key> Keys() const noexcept {
+        return {keys_.Data(), keys_.Size()};
+    }
+
+    const_iterator LowerBound(const Key& key) const {
+        return begin() + index_.LowerBound(Keys(), key, comp_);
+    }
+
+    const_iterator Find(const Key& key) const {
+        return begin() + index_.Find(Keys(), key, comp_);
+    }
+
+    bool Contains(const Key& key) const {
+        return Find(key) != end();
+    }
+
+    std::pair<iterator, bool> Insert(const Key& key) {
+        return InsertImpl(key);
+    }
+
+    std::pair<iterator, bool> Insert(Key&& key) {
+        return InsertImpl(std::move(key));
+    }
+
+    // Добавляет ключи диапазона: упорядочивает их отдельно и вливает в множество за один
+    // проход слияния. Если все новые ключи больше имеющихся, они просто дописываются в конец.
+    // Не добавляет ключи, равные уже имеющимся. Если перенос ключа бросит исключение,
+    // множество очищается
+    template <std::ranges::input_range Range>
+    void InsertRange(Range&& range) {
+        KeyContainer incoming(keys_.GetAllocator());
+        incoming.Append(std::forward<Range>(range));
+        flat_container::SortUnique(incoming, comp_);
+        Merge(incoming);
+    }
+
+    template <std::ranges::input_range Range>
+    void InsertRange(SortedUniqueTag, Range&& range) {
+        KeyContainer incoming(keys_.GetAllocator());
+        incoming.Append(std::forward<Range>(range));
+        assert(flat_container::IsSortedUnique(incoming, comp_));
+        Merge(incoming);
+    }
+
+    size_t Erase(const Key& key) {
+        const const_iterator it = Find(key);
+        if (it == end()) {
+            return 0;
+        }
+        Erase(it);
+        return 1;
+    }
+
+    iterator Erase(const_iterator pos) {
+        const size_t index = pos - begin();
+        keys_.Erase(keys_.begin() + index);
+        index_.Build(Keys());
+        return begin() + index;
+    }
+
+    void Reserve(size_t new_capacity) {
+        keys_.Reserve(new_capacity);
+    }
+
+    void Clear() noexcept {
+        keys_.Clear();
+        index_.Build({});
+    }
+
+    // Забирает упорядоченные ключи, оставляя множество пустым
+    KeyContainer Extract() noexcept {
+        KeyContainer keys = std::move(keys_);
+        Clear();
+        return keys;
+    }
+
+    const_iterator begin() const noexcept {
+        return keys_.Data();
+    }
+
+    const_iterator end() const noexcept {
+        return keys_.Data() + keys_.Size();
+    }
+
+    friend bool operator==(const FlatSet& lhs, const FlatSet& rhs) {
+        return lhs.keys_ == rhs.keys_;
+    }
+
+private:
+    template <typename K>
+    std::pair<iterator, bool> InsertImpl(K&& key) {
+        const const_iterator it = LowerBound(key);
+        if (it != end() && !comp_(key, *it)) {
+            return {it, false};
+        }
+        const size_t index = it - begin();
+        keys_.Emplace(keys_.begin() + index, std::forward<K>(key));
+        index_.Build(Keys());
+        return {begin() + index, true};
+    }
+
+    void Merge(KeyContainer& incoming) {
+        if (incoming.Size() == 0) {
+            return;
+        }
+        try {
+            if (keys_.Size() == 0 || comp_(keys_[keys_.Size() - 1], incoming[0])) {
+                keys_.Reserve(keys_.Size() + incoming.Size());
+                keys_.Insert(keys_.end(), std::make_move_iterator(incoming.begin()), std::make_move_iterator(incoming.end()));
+            }
+            else {
+                KeyContainer merged(keys_.GetAllocator());
+                merged.Reserve(keys_.Size() + incoming.Size());
+                auto it = keys_.begin();
+                auto in = incoming.begin();
+                while (it != keys_.end() && in != incoming.end()) {
+                    if (comp_(*in, *it)) {
+                        merged.EmplaceBack(std::move(*in++));
+                        continue;
+                    }
+                    if (!comp_(*it, *in)) {
+                        ++in;
+                    }
+                    merged.EmplaceBack(std::move(*it++));
+                }
+                merged.Insert(merged.end(), std::make_move_iterator(it), std::make_move_iterator(keys_.end()));
+                merged.Insert(merged.end(), std::make_move_iterator(in), std::make_move_iterator(incoming.end()));
+                keys_ = std::move(merged);
+            }
+        }
+        catch (...) {
+            // Часть ключей могла быть перенесена, и порядок нарушен
+            Clear();
+            throw;
+        }
+        index_.Build(Keys());
+    }
+
+    KeyContainer keys_;
+    [[no_unique_address]] Compare comp_;
+    [[no_unique_address]] typename Lookup::template Index<Key> index_;
+};
+
+// Пара ссылок на ключ и значение элемента FlatMap. Присваивание пишет в них, поля first и
+// second и std::get работают как у std::pair. Собственный тип нужен для специализаций
+// std::basic_common_reference ниже: с ними у пары ссылок и пары значений есть общий ссылочный
+// тип, и итераторы FlatMap удовлетворяют std::random_access_iterator
+template <typename KeyRef, typename ValueRef>
+class FlatMapReference : public std::pair<KeyRef, ValueRef> {
+    using Base = std::pair<KeyRef, ValueRef>;
+
+public:
+    using Base::Base;
+    using Base::operator=;
+
+    // Ссылается на поля пары значений
+    template <typename K, typename V>
+        requires(std::is_constructible_v<KeyRef, K&> && std::is_constructible_v<ValueRef, V&>)
+    FlatMapReference(std::pair<K, V>& pair) noexcept
+        : Base(pair.first, pair.second) {
+    }
+};
+
+// Общий тип пары ссылок и пары значений — пара ссылок с общими для них квалификаторами
+template <typename KeyRef, typename ValueRef, typename K, typename V, template <typename> class RefQual,
+          template <typename> class PairQual>
+struct std::basic_common_reference<FlatMapReference<KeyRef, ValueRef>, std::pair<K, V>, RefQual, PairQual> {
+    using type = FlatMapReference<std::common_reference_t<RefQual<KeyRef>, PairQual<K>>,
+                                  std::common_reference_t<RefQual<ValueRef>, PairQual<V>>>;
+};
+
+template <typename K, typename V, typename KeyRef, typename ValueRef, template <typename> class PairQual,
+          template <typename> class RefQual>
+struct std::basic_common_reference<std::pair<K, V>, FlatMapReference<KeyRef, ValueRef>, PairQual, RefQual> {
+    using type = FlatMapReference<std::common_reference_t<PairQual<K>, RefQual<KeyRef>>,
+                                  std::common_reference_t<PairQual<V>, RefQual<ValueRef>>>;
+};
+
+// Ассоциативный массив на двух отсортированных Vector: ключи хранятся отдельно от значений,
+// поэтому поиск читает плотный массив одних ключей, а значения подгружаются только для
+// найденного. Операции устроены как у FlatSet. Итераторы возвращают пару ссылок
+// FlatMapReference<const Key&, Value&> на ключ и значение.
+// Если исключение нарушит соответствие ключей и значений, массив очищается
+template <typename Key, typename Value, typename Compare = std::less<Key>, typename Lookup = BranchlessLookup,
+          typename KeyContainer = Vector<Key>, typename ValueContainer = Vector<Value>>
+class FlatMap {
+    template <bool IsConst>
+    class BasicIterator;
+
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<Key, Value>;
+    using reference = FlatMapReference<const Key&, Value&>;
+    using const_reference = FlatMapReference<const Key&, const Value&>;
+    using key_compare = Compare;
+    using key_container_type = KeyContainer;
+    using mapped_container_type = ValueContainer;
+    using iterator = BasicIterator<false>;
+    using const_iterator = BasicIterator<true>;
+
+    FlatMap() = default;
+
+    explicit FlatMap(const Compare& comp)
+        : comp_(comp) {
+    }
+
+    // Упорядочивает пары (keys[i], values[i]) по ключу и удаляет повторы, оставляя первую
+    // из пар с равными ключами. Если ключей и значений не поровну, бросает std::invalid_argument
+    FlatMap(KeyContainer keys, ValueContainer values, const Compare& comp = Compare())
+        : keys_(std::move(keys))
+        , values_(std::move(values))
+        , comp_(comp) {
+        flat_container::CheckSameSize(keys_, values_);
+        flat_container::SortUniqueByKey(keys_, values_, comp_);
+        index_.Build(Keys());
+    }
+
+    FlatMap(SortedUniqueTag, KeyContainer keys, ValueContainer values, const Compare& comp = Compare())
+        : keys_(std::move(keys))
+        , values_(std::move(values))
+        , comp_(comp) {
+        flat_container::CheckSameSize(keys_, values_);
+        assert(flat_container::IsSortedUnique(keys_, comp_));
+        index_.Build(Keys());
+    }
+
+    FlatMap(std::initializer_list<value_type> pairs, const Compare& comp = Compare())
+        : comp_(comp) {
+        Split(pairs, keys_, values_);
+        flat_container::SortUniqueByKey(keys_, values_, comp_);
+        index_.Build(Keys());
+    }
+
+    size_t Size() const noexcept {
+        return keys_.Size();
+    }
+
+    std::span<const Key> Keys() const noexcept {
+        return {keys_.Data(), keys_.Size()};
+    }
+
+    std::span<const Value> Values() const noexcept {
+        return {values_.Data(), values_.Size()};
+    }
+
+    std::span<Value> Values() noexcept {
+        return {values_.Data(), values_.Size()};
+    }
+
+    iterator LowerBound(const Key& key) {
+        return {this, LowerBoundIndex(key)};
+    }
+
+    const_iterator LowerBound(const Key& key) const {
+        return {this, LowerBoundIndex(key)};
+    }
+
+    iterator Find(const Key& key) {
+        return {this, FindIndex(key)};
+    }
+
+    const_iterator Find(const Key& key) const {
+        return {this, FindIndex(key)};
+    }
+
+    bool Contains(const Key& key) const {
+        return FindIndex(key) != Size();
+    }
+
+    // Значение по ключу. Если ключа нет, добавляет его со значением по умолчанию
+    Value& operator[](const Key& key) {
+        return values_[TryEmplace(key).first.index_];
+    }
+
+    Value& operator[](Key&& key) {
+        return values_[TryEmplace(std::move(key)).first.index_];
+    }
+
+    // Добавляет ключ со значением из args, если ключа ещё нет. Иначе args не используются
+    template <typename... Args>
+    std::pair<iterator, bool> TryEmplace(const Key& key, Args&&... args) {
+        return TryEmplaceImpl(key, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> TryEmplace(Key&& key, Args&&... args) {
+        return TryEmplaceImpl(std::move(key), std::forward<Args>(args)...);
+    }
+
+    std::pair<iterator, bool> Insert(const value_type& pair) {
+        return TryEmplace(pair.first, pair.second);
+    }
+
+    std::pair<iterator, bool> Insert(value_type&& pair) {
+        return TryEmplace(std::move(pair.first), std::move(pair.second));
+    }
+
+    template <typename V>
+    std::pair<iterator, bool> InsertOrAssign(const Key& key, V&& value) {
+        auto result = TryEmplace(key, std::forward<V>(value));
+        if (!result.second) {
+            values_[result.first.index_] = std::forward<V>(value);
+        }
+        return result;
+    }
+
+    // Добавляет пары диапазона (элементы вида std::pair<Key, Value>) так же, как FlatSet::InsertRange.
+    // Пары с ключами, которые уже есть, не добавляются
+    template <std::ranges::input_range Range>
+    void InsertRange(Range&& range) {
+        KeyContainer incoming_keys(keys_.GetAllocator());
+        ValueContainer incoming_values(values_.GetAllocator());
+        Split(std::forward<Range>(range), incoming_keys, incoming_values);
+        flat_container::SortUniqueByKey(incoming_keys, incoming_values, comp_);
+        Merge(incoming_keys, incoming_values);
+    }
+
+    template <std::ranges::input_range Range>
+    void InsertRange(SortedUniqueTag, Range&& range) {
+        KeyContainer incoming_keys(keys_.GetAllocator());
+        ValueContainer incoming_values(values_.GetAllocator());
+        Split(std::forward<Range>(range), incoming_keys, incoming_values);
+        assert(flat_container::IsSortedUnique(incoming_keys, comp_));
+        Merge(incoming_keys, incoming_values);
+    }
+
+    size_t Erase(const Key& key) {
+        const size_t index = FindIndex(key);
+        if (index == Size()) {
+            return 0;
+        }
+        EraseAt(index);
+        return 1;
+    }
+
+    iterator Erase(const_iterator pos) {
+        EraseAt(pos.index_);
+        return {this, pos.index_};
+    }
+
+    void Reserve(size_t new_capacity) {
+        keys_.Reserve(new_capacity);
+        values_.Reserve(new_capacity);
+    }
+
+    void Clear() noexcept {
+        keys_.Clear();
+        values_.Clear();
+        index_.Build({});
+    }
+
+    iterator begin() noexcept {
+        return {this, 0};
+    }
+
+    iterator end() noexcept {
+        return {this, Size()};
+    }
+
+    const_iterator begin() const noexcept {
+        return {this, 0};
+    }
+
+    const_iterator end() const noexcept {
+        return {this, Size()};
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    friend bool operator==(const FlatMap& lhs, const FlatMap& rhs) {
+        return lhs.keys_ == rhs.keys_ && lhs.values_ == rhs.values_;
+    }
+
+private:
+    template <typename Range>
+    static void Split(Range&& range, KeyContainer& keys, ValueContainer& values) {
+        if constexpr (std::ranges::sized_range<Range>) {
+            keys.Reserve(std::ranges::size(range));
+            values.Reserve(std::ranges::size(range));
+        }
+        for (auto&& pair : range) {
+            keys.EmplaceBack(std::get<0>(std::forward<decltype(pair)>(pair)));
+            values.EmplaceBack(std::get<1>(std::forward<decltype(pair)>(pair)));
+        }
+    }
+
+    reference PairAt(size_t index) noexcept {
+        assert(index < Size());
+        return {keys_[index], values_[index]};
+    }
+
+    const_reference PairAt(size_t index) const noexcept {
+        assert(index < Size());
+        return {keys_[index], values_[index]};
+    }
+
+    size_t LowerBoundIndex(const Key& key) const {
+        return index_.LowerBound(Keys(), key, comp_);
+    }
+
+    size_t FindIndex(const Key& key) const {
+        return index_.Find(Keys(), key, comp_);
+    }
+
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> TryEmplaceImpl(K&& key, Args&&... args) {
+        const size_t index = LowerBoundIndex(key);
+        if (index != Size() && !comp_(key, keys_[index])) {
+            return {{this, index}, false};
+        }
+        values_.Emplace(values_.begin() + index, std::forward<Args>(args)...);
+        try {
+            keys_.Emplace(keys_.begin() + index, std::forward<K>(key));
+        }
+        catch (...) {
+            values_.Erase(values_.begin() + index);
+            throw;
+        }
+        index_.Build(Keys());
+        return {{this, index}, true};
+    }
+
+    void EraseAt(size_t index) {
+        try {
+            keys_.Erase(keys_.begin() + index);
+            values_.Erase(values_.begin() + index);
+        }
+        catch (...) {
+            Clear();
+            throw;
+        }
+        index_.Build(Keys());
+    }
+
+    void Merge(KeyContainer& incoming_keys, ValueContainer& incoming_values) {
+        if (incoming_keys.Size() == 0) {
+            return;
+        }
+        try {
+            if (keys_.Size() == 0 || comp_(keys_[keys_.Size() - 1], incoming_keys[0])) {
+                Reserve(keys_.Size() + incoming_keys.Size());
+                keys_.Insert(keys_.end(), std::make_move_iterator(incoming_keys.begin()),
+                             std::make_move_iterator(incoming_keys.end()));
+                values_.Insert(values_.end(), std::make_move_iterator(incoming_values.begin()),
+                               std::make_move_iterator(incoming_values.end()));
+            }
+            else {
+                KeyContainer merged_keys(keys_.GetAllocator());
+                ValueContainer merged_values(values_.GetAllocator());
+                merged_keys.Reserve(keys_.Size() + incoming_keys.Size());
+                merged_values.Reserve(keys_.Size() + incoming_keys.Size());
+                size_t i = 0;
+                size_t j = 0;
+                auto take = [&](KeyContainer& keys, ValueContainer& values, size_t& index) {
+                    merged_keys.EmplaceBack(std::move(keys[index]));
+                    merged_values.EmplaceBack(std::move(values[index]));
+                    ++index;
+                };
+                while (i < keys_.Size() && j < incoming_keys.Size()) {
+                    if (comp_(incoming_keys[j], keys_[i])) {
+                        take(incoming_keys, incoming_values, j);
+                        continue;
+                    }
+                    if (!comp_(keys_[i], incoming_keys[j])) {
+                        ++j;
+                    }
+                    take(keys_, values_, i);
+                }
+                while (i < keys_.Size()) {
+                    take(keys_, values_, i);
+                }
+                while (j < incoming_keys.Size()) {
+                    take(incoming_keys, incoming_values, j);
+                }
+                keys_ = std::move(merged_keys);
+                values_ = std::move(merged_values);
+            }
+        }
+        catch (...) {
+            Clear();
+            throw;
+        }
+        index_.Build(Keys());
+    }
+
+    KeyContainer keys_;
+    ValueContainer values_;
+    [[no_unique_address]] Compare comp_;
+    [[no_unique_address]] typename Lookup::template Index<Key> index_;
+};
+
+template <typename Key, typename Value, typename Compare, typename Lookup, typename KeyContainer, typename ValueContainer>
+template <bool IsConst>
+class FlatMap<Key, Value, Compare, Lookup, KeyContainer, ValueContainer>::BasicIterator {
+    using Owner = std::conditional_t<IsConst, const FlatMap, FlatMap>;
+
+public:
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = FlatMap::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::conditional_t<IsConst, FlatMap::const_reference, FlatMap::reference>;
+
+    // Пара ссылок создаётся на лету, поэтому operator-> возвращает её обёртку
+    struct pointer {
+        reference pair;
+
+        const reference* operator->() const noexcept {
+            return &pair;
+        }
+    };
+
+    BasicIterator() = default;
+
+    BasicIterator(Owner* owner, size_t index) noexcept
+        : owner_(owner)
+        , index_(index) {
+    }
+
+    operator BasicIterator<true>() const noexcept requires(!IsConst) {
+        return {owner_, index_};
+    }
+
+    reference operator*() const noexcept {
+        return owner_->PairAt(index_);
+    }
+
+    pointer operator->() const noexcept {
+        return {**this};
+    }
+
+    reference operator[](difference_type offset) const noexcept {
+        return owner_->PairAt(index_ + offset);
+    }
+
+    BasicIterator& operator++() noexcept {
+        ++index_;
+        return *this;
+    }
+
+    BasicIterator operator++(int) noexcept {
+        return {owner_, index_++};
+    }
+
+    BasicIterator& operator--() noexcept {
+        --index_;
+        return *this;
+    }
+
+    BasicIterator operator--(int) noexcept {
+        return {owner_, index_--};
+    }
+
+    BasicIterator& operator+=(difference_type offset) noexcept {
+        index_ += offset;
+        return *this;
+    }
+
+    BasicIterator& operator-=(difference_type offset) noexcept {
+        index_ -= offset;
+        return *this;
+    }
+
+    friend BasicIterator operator+(BasicIterator it, difference_type offset) noexcept {
+        return it += offset;
+    }
+
+    friend BasicIterator operator+(difference_type offset, BasicIterator it) noexcept {
+        return it += offset;
+    }
+
+    friend BasicIterator operator-(BasicIterator it, difference_type offset) noexcept {
+        return it -= offset;
+    }
+
+    friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+        return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+    }
+
+    friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+        return lhs.index_ == rhs.index_;
+    }
+
+    friend auto operator<=>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+        return lhs.index_ <=> rhs.index_;
+    }
+
+private:
+    friend class FlatMap;
+
+    Owner* owner_ = nullptr;
+    size_t index_ = 0;
+};
+
+static_assert(std::random_access_iterator<FlatMap<int, int>::iterator>);
+static_assert(std::random_access_iterator<FlatMap<int, int>::const_iterator>);
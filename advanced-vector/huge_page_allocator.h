@@ -0,0 +1,262 @@
+#pragma once
+#include "allocators.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <system_error>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Как выделять блоки от порога HugePageOptions::threshold_bytes
+enum class HugePageMode {
+    // Обычные страницы mmap без подсказок
+    kNone,
+    // Прозрачные большие страницы: mmap и madvise(MADV_HUGEPAGE)
+    kTransparent,
+    // Заранее зарезервированные страницы hugetlbfs (MAP_HUGETLB). Если их нет, блок
+    // выделяется как при kTransparent
+    kExplicit,
+};
+
+struct HugePageOptions {
+    // Блоки меньше порога выделяются через operator new
+    size_t threshold_bytes = size_t{2} << 20;
+    HugePageMode mode = HugePageMode::kTransparent;
+    // Узел NUMA, к которому привязываются страницы (mbind с MPOL_BIND), или -1
+    int numa_node = -1;
+    // Заполнить страницы из выделяющего потока сразу, чтобы ядро разместило их на его узле
+    bool first_touch = false;
+};
+
+// Аллокатор для очень больших векторов. Блоки от порога выделяются через mmap, округляются
+// до 2 МиБ и размещаются на больших страницах, что уменьшает промахи TLB. Страницы можно
+// привязать к узлу NUMA или сразу заполнить из выделяющего потока. Настройки хранятся в
+// аллокаторе, поэтому Vector сохраняет их при росте. reallocate расширяет блок через mremap,
+// и тривиально перемещаемые элементы при росте обычно не копируются.
+// Ошибки системных вызовов сообщаются исключением std::system_error
+template <typename T>
+class HugePageAllocator {
+public:
+    using value_type = T;
+
+    static constexpr size_t kHugePageSize = size_t{2} << 20;
+
+    HugePageAllocator() noexcept = default;
+
+    explicit HugePageAllocator(const HugePageOptions& options) noexcept
+        : options_(options) {
+    }
+
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U>& other) noexcept
+        : options_(other.GetOptions()) {
+    }
+
+    T* allocate(size_t n) {
+        return allocate_at_least(n).ptr;
+    }
+
+    // Блоки из mmap отдаются целиком до границы большой страницы
+    AllocationResult<T> allocate_at_least(size_t n) {
+        const size_t bytes = Bytes(n);
+        if (!IsMapped(bytes)) {
+            return {static_cast<T*>(::operator new(bytes, std::align_val_t{alignof(T)})), n};
+        }
+        const size_t length = MappedLength(bytes);
+        return {static_cast<T*>(Map(length)), length / sizeof(T)};
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        const size_t bytes = n * sizeof(T);
+        if (IsMapped(bytes)) {
+            ::munmap(p, MappedLength(bytes));
+        }
+        else {
+            ::operator delete(p, std::align_val_t{alignof(T)});
+        }
+    }
+
+    // Перевыделяет блок, сохраняя байты. Отображения растут через mremap, остальные
+    // переходы между кучей и mmap, а также отображения, которые mremap не смог перенести
+    // (например, страницы hugetlbfs при пустом пуле), копируют содержимое
+    T* reallocate(T* p, size_t n, size_t new_n) {
+        const size_t bytes = n * sizeof(T);
+        const size_t new_bytes = Bytes(new_n);
+        if (IsMapped(bytes) && IsMapped(new_bytes)) {
+            const size_t length = MappedLength(bytes);
+            const size_t new_length = MappedLength(new_bytes);
+            // Ошибка в настройках обнаруживается до mremap, пока блок p ещё на месте
+            const unsigned long node_mask = NodeMask();
+            if (void* address = Remap(p, length, new_length); address != MAP_FAILED) {
+                if (new_length > length) {
+                    ExtendPolicy(static_cast<std::byte*>(address), new_length, length, node_mask);
+                }
+                return static_cast<T*>(address);
+            }
+        }
+        T* new_p = allocate(new_n);
+        if (p != nullptr) {
+            std::memcpy(static_cast<void*>(new_p), static_cast<const void*>(p), std::min(bytes, new_bytes));
+            deallocate(p, n);
+        }
+        return new_p;
+    }
+
+    const HugePageOptions& GetOptions() const noexcept {
+        return options_;
+    }
+
+    // Блок освобождается тем же способом, которым выделен, если пороги совпадают
+    template <typename U>
+    bool operator==(const HugePageAllocator<U>& other) const noexcept {
+        return options_.threshold_bytes == other.GetOptions().threshold_bytes;
+    }
+
+private:
+    [[noreturn]] static void ThrowSystemError(const char* call) {
+        throw std::system_error(errno, std::generic_category(), call);
+    }
+
+    static size_t Bytes(size_t n) {
+        if (n > (std::numeric_limits<size_t>::max() - kHugePageSize) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return n * sizeof(T);
+    }
+
+    static size_t MappedLength(size_t bytes) noexcept {
+        return (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    }
+
+    bool IsMapped(size_t bytes) const noexcept {
+        return bytes != 0 && bytes >= options_.threshold_bytes;
+    }
+
+    void* Map(size_t length) {
+        void* address = MAP_FAILED;
+        constexpr int kFlags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+        if (options_.mode == HugePageMode::kExplicit) {
+            // Без MAP_NORESERVE ядро резервирует страницы сразу, и при пустом пуле hugetlbfs
+            // mmap возвращает ошибку вместо SIGBUS при первом обращении
+            address = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        }
+        const bool explicit_pages = address != MAP_FAILED;
+        if (!explicit_pages) {
+            address = MapAligned(length, kFlags);
+        }
+        try {
+            ApplyPolicy(static_cast<std::byte*>(address), length, 0, explicit_pages);
+        }
+        catch (...) {
+            ::munmap(address, length);
+            throw;
+        }
+        return address;
+    }
+
+    // Меняет длину отображения, сохраняя выравнивание начала по kHugePageSize. Сначала
+    // отображение растёт на месте, а если за ним занято, переезжает через MREMAP_FIXED
+    // на заранее выровненный участок: просто MREMAP_MAYMOVE выбрал бы любой адрес, кратный
+    // обычной странице. Возвращает MAP_FAILED, если mremap не справился, и блок p не меняется
+    static void* Remap(void* p, size_t length, size_t new_length) {
+        void* address = ::mremap(p, length, new_length, 0);
+        if (address != MAP_FAILED) {
+            return address;
+        }
+        void* target;
+        try {
+            target = MapAligned(new_length, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE);
+        }
+        catch (const std::system_error&) {
+            return MAP_FAILED;
+        }
+        address = ::mremap(p, length, new_length, MREMAP_MAYMOVE | MREMAP_FIXED, target);
+        if (address == MAP_FAILED) {
+            ::munmap(target, new_length);
+        }
+        return address;
+    }
+
+    // Отображает length байт с адреса, кратного kHugePageSize: иначе ядро не сможет покрыть
+    // большими страницами начало и конец блока. Лишние края отображения снимаются
+    static void* MapAligned(size_t length, int flags) {
+        void* raw = ::mmap(nullptr, length + kHugePageSize, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (raw == MAP_FAILED) {
+            ThrowSystemError("mmap");
+        }
+        auto* begin = static_cast<std::byte*>(raw);
+        const size_t head = (kHugePageSize - reinterpret_cast<uintptr_t>(begin) % kHugePageSize) % kHugePageSize;
+        if (head != 0) {
+            ::munmap(begin, head);
+        }
+        // Запас в kHugePageSize байт делится между началом и концом, и конец не бывает пустым
+        ::munmap(begin + head + length, kHugePageSize - head);
+        return begin + head;
+    }
+
+    static constexpr unsigned long kMaxNode = sizeof(unsigned long) * CHAR_BIT;
+
+    // Маска узла NUMA для mbind или 0, если узел не задан
+    unsigned long NodeMask() const {
+        if (options_.numa_node < 0) {
+            return 0;
+        }
+        if (options_.numa_node >= static_cast<int>(kMaxNode)) {
+            throw std::system_error(EINVAL, std::generic_category(), "NUMA node is out of range");
+        }
+        return 1UL << options_.numa_node;
+    }
+
+    // Применяет настройки к байтам [touched, length) отображения
+    void ApplyPolicy(std::byte* address, size_t length, size_t touched, bool explicit_pages = false) {
+        const unsigned long node_mask = NodeMask();
+        Advise(address, length, explicit_pages);
+        if (node_mask != 0 && !BindToNode(address, length, node_mask)) {
+            ThrowSystemError("mbind");
+        }
+        Touch(address, length, touched);
+    }
+
+    // Применяет настройки к отображению, которое mremap уже перенёс или расширил. Исключение
+    // здесь оставило бы вектор с прежним адресом блока, поэтому ошибка mbind игнорируется:
+    // страницы просто размещаются по политике процесса
+    void ExtendPolicy(std::byte* address, size_t length, size_t touched, unsigned long node_mask) const noexcept {
+        Advise(address, length, false);
+        if (node_mask != 0) {
+            BindToNode(address, length, node_mask);
+        }
+        Touch(address, length, touched);
+    }
+
+    void Advise(std::byte* address, size_t length, bool explicit_pages) const noexcept {
+        if (options_.mode != HugePageMode::kNone && !explicit_pages) {
+            // Прозрачные большие страницы могут быть отключены в системе. Это лишь подсказка
+            ::madvise(address, length, MADV_HUGEPAGE);
+        }
+    }
+
+    // mbind из libnuma вызывается напрямую, чтобы не зависеть от неё
+    static bool BindToNode(std::byte* address, size_t length, unsigned long node_mask) noexcept {
+        constexpr int kMpolBind = 2;
+        return ::syscall(SYS_mbind, address, length, kMpolBind, &node_mask, kMaxNode + 1, 0) == 0;
+    }
+
+    void Touch(std::byte* address, size_t length, size_t touched) const noexcept {
+        if (options_.first_touch) {
+            const auto page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+            for (size_t offset = touched; offset < length; offset += page_size) {
+                static_cast<volatile std::byte*>(address)[offset] = std::byte{0};
+            }
+        }
+    }
+
+    HugePageOptions options_;
+};
@@ -0,0 +1,282 @@
+#pragma once
+#include "vector.h"
+
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+enum class MappedVectorMode {
+    kReadWrite,
+    // Файл только читается. У такого вектора нет изменяющих методов, а элементы доступны
+    // только через константные ссылки и итераторы (см. ReadOnlyMappedVector)
+    kReadOnly,
+};
+
+// Подсказки ядру о порядке обращения к страницам (madvise)
+enum class MappedAccess {
+    kNormal,
+    kSequential,
+    kRandom,
+    // Начать подгрузку страниц заранее
+    kWillNeed,
+};
+
+// Вектор, элементы которого лежат в файле, отображённом в память (mmap с MAP_SHARED).
+// Файл содержит только сами элементы, поэтому открытие не читает его и занимает O(1),
+// а страницы подгружаются по мере обращения и разделяются через page cache между процессами.
+// Вместимость равна длине файла: при росте файл удлиняется ftruncate, а отображение
+// расширяется mremap. При разрушении файл обрезается до Size() элементов.
+// Режим Mode задаётся типом: в режиме kReadOnly изменяющие методы и неконстантный доступ
+// к элементам не объявлены, и range-for или алгоритм над таким вектором видят const T.
+// Ошибки системных вызовов сообщаются исключением std::system_error
+template <typename T, typename GrowthPolicy = DoublingGrowth, MappedVectorMode Mode = MappedVectorMode::kReadWrite>
+class MappedVector {
+    static_assert(std::is_trivially_copyable_v<T>, "MappedVector stores elements as raw file bytes");
+
+    static constexpr bool kReadOnly = Mode == MappedVectorMode::kReadOnly;
+
+public:
+    using value_type = T;
+    using iterator = std::conditional_t<kReadOnly, const T*, T*>;
+    using const_iterator = const T*;
+
+    // Открывает файл path, создавая его в режиме kReadWrite. Длина файла должна быть кратна sizeof(T)
+    explicit MappedVector(const std::filesystem::path& path) {
+        fd_ = ::open(path.c_str(), kReadOnly ? O_RDONLY | O_CLOEXEC : O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd_ < 0) {
+            ThrowSystemError("open");
+        }
+        try {
+            struct stat file_stat;
+            if (::fstat(fd_, &file_stat) != 0) {
+                ThrowSystemError("fstat");
+            }
+            const auto file_size = static_cast<size_t>(file_stat.st_size);
+            if (file_size % sizeof(T) != 0) {
+                throw std::system_error(EINVAL, std::generic_category(), "MappedVector file size is not a multiple of sizeof(T)");
+            }
+            Map(file_size / sizeof(T));
+            size_ = capacity_;
+        }
+        catch (...) {
+            ::close(fd_);
+            throw;
+        }
+    }
+
+    MappedVector(const MappedVector&) = delete;
+    MappedVector& operator=(const MappedVector&) = delete;
+
+    MappedVector(MappedVector&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr))
+        , size_(std::exchange(other.size_, 0))
+        , capacity_(std::exchange(other.capacity_, 0))
+        , fd_(std::exchange(other.fd_, -1)) {
+    }
+
+    MappedVector& operator=(MappedVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Close();
+            data_ = std::exchange(rhs.data_, nullptr);
+            size_ = std::exchange(rhs.size_, 0);
+            capacity_ = std::exchange(rhs.capacity_, 0);
+            fd_ = std::exchange(rhs.fd_, -1);
+        }
+        return *this;
+    }
+
+    ~MappedVector() {
+        Close();
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return capacity_;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    // Страницы отображения только для чтения недоступны для записи, поэтому изменяемая
+    // ссылка выдаётся только в режиме kReadWrite
+    T& operator[](size_t index) noexcept requires(!kReadOnly) {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    // Удлиняет файл до new_capacity элементов. Адреса элементов могут измениться
+    void Reserve(size_t new_capacity) requires(!kReadOnly) {
+        if (new_capacity <= capacity_) {
+            return;
+        }
+        if (::ftruncate(fd_, static_cast<off_t>(new_capacity * sizeof(T))) != 0) {
+            ThrowSystemError("ftruncate");
+        }
+        try {
+            Map(new_capacity);
+        }
+        catch (...) {
+            // Длина файла возвращается к вместимости: Close обрезает файл, только если
+            // Size() меньше Capacity()
+            [[maybe_unused]] int result = ::ftruncate(fd_, static_cast<off_t>(capacity_ * sizeof(T)));
+            throw;
+        }
+    }
+
+    // Новые элементы заполняются нулевыми байтами
+    void Resize(size_t new_size) requires(!kReadOnly) {
+        if (new_size > size_) {
+            Reserve(new_size);
+            // Хвост файла после ftruncate уже нулевой, но память за size_ могла остаться от удалённых элементов
+            std::memset(static_cast<void*>(data_ + size_), 0, (new_size - size_) * sizeof(T));
+        }
+        size_ = new_size;
+    }
+
+    void PushBack(const T& value) requires(!kReadOnly) {
+        EmplaceBack(value);
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) requires(!kReadOnly) {
+        if (size_ == capacity_) {
+            // Аргументы могут ссылаться на элементы, которые mremap переместит
+            T value(std::forward<Args>(args)...);
+            Reserve(GrowthPolicy::NextCapacity(capacity_, size_ + 1, sizeof(T)));
+            return *std::construct_at(data_ + size_++, value);
+        }
+        return *std::construct_at(data_ + size_++, std::forward<Args>(args)...);
+    }
+
+    void PopBack() noexcept requires(!kReadOnly) {
+        assert(size_ > 0);
+        --size_;
+    }
+
+    void Clear() noexcept requires(!kReadOnly) {
+        size_ = 0;
+    }
+
+    // Синхронно записывает изменённые страницы на диск (msync)
+    void Flush() {
+        if (size_ != 0 && !kReadOnly && ::msync(data_, size_ * sizeof(T), MS_SYNC) != 0) {
+            ThrowSystemError("msync");
+        }
+    }
+
+    // Сообщает ядру, как будут читаться элементы, чтобы оно настроило упреждающее чтение
+    void Advise(MappedAccess access) {
+        if (capacity_ == 0) {
+            return;
+        }
+        int advice = MADV_NORMAL;
+        switch (access) {
+            case MappedAccess::kNormal:
+                advice = MADV_NORMAL;
+                break;
+            case MappedAccess::kSequential:
+                advice = MADV_SEQUENTIAL;
+                break;
+            case MappedAccess::kRandom:
+                advice = MADV_RANDOM;
+                break;
+            case MappedAccess::kWillNeed:
+                advice = MADV_WILLNEED;
+                break;
+        }
+        if (::madvise(data_, capacity_ * sizeof(T), advice) != 0) {
+            ThrowSystemError("madvise");
+        }
+    }
+
+    iterator begin() noexcept requires(!kReadOnly) {
+        return data_;
+    }
+
+    iterator end() noexcept requires(!kReadOnly) {
+        return data_ + size_;
+    }
+
+    const_iterator begin() const noexcept {
+        return data_;
+    }
+
+    const_iterator end() const noexcept {
+        return data_ + size_;
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    [[noreturn]] static void ThrowSystemError(const char* call) {
+        throw std::system_error(errno, std::generic_category(), call);
+    }
+
+    // Отображает первые capacity элементов файла, расширяя текущее отображение
+    void Map(size_t capacity) {
+        if (capacity == 0) {
+            return;
+        }
+        void* address;
+        if (data_ == nullptr) {
+            address = ::mmap(nullptr, capacity * sizeof(T), kReadOnly ? PROT_READ : PROT_READ | PROT_WRITE,
+                             MAP_SHARED, fd_, 0);
+        }
+        else {
+            address = ::mremap(data_, capacity_ * sizeof(T), capacity * sizeof(T), MREMAP_MAYMOVE);
+        }
+        if (address == MAP_FAILED) {
+            ThrowSystemError(data_ == nullptr ? "mmap" : "mremap");
+        }
+        data_ = static_cast<T*>(address);
+        capacity_ = capacity;
+    }
+
+    // Снимает отображение, обрезает файл до Size() элементов и закрывает его. Ошибки игнорируются
+    void Close() noexcept {
+        if (fd_ < 0) {
+            return;
+        }
+        if (data_ != nullptr) {
+            ::munmap(data_, capacity_ * sizeof(T));
+        }
+        if (!kReadOnly && size_ != capacity_) {
+            [[maybe_unused]] int result = ::ftruncate(fd_, static_cast<off_t>(size_ * sizeof(T)));
+        }
+        ::close(fd_);
+        data_ = nullptr;
+        size_ = capacity_ = 0;
+        fd_ = -1;
+    }
+
+    T* data_ = nullptr;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+    int fd_ = -1;
+};
+
+// Вектор над файлом, открытым только для чтения
+template <typename T>
+using ReadOnlyMappedVector = MappedVector<T, DoublingGrowth, MappedVectorMode::kReadOnly>;
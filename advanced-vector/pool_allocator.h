@@ -0,0 +1,326 @@
+#pragma once
+#include "allocators.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Пул буферов по классам размеров для Vector. Блоки от 64 байт до 1 МиБ округляются вверх
+// до степени двойки, и освобождённый блок не возвращается в malloc, а попадает в список
+// свободных блоков своего класса в кеше текущего потока. Следующий вектор того же класса
+// получает его без блокировок. Переполненный кеш отдаёт половину списка в общее хранилище
+// (depot), откуда блоки забирают другие потоки, а при завершении потока кеш сбрасывается туда
+// целиком. Блок, освобождённый в другом потоке, просто оседает в кеше этого потока.
+// Объём хранилища ограничен: лишние блоки возвращаются в operator delete
+namespace vector_pool {
+
+inline constexpr size_t kMinClassSize = 64;
+inline constexpr size_t kClassCount = 15;
+inline constexpr size_t kMaxClassSize = kMinClassSize << (kClassCount - 1);
+
+inline size_t ClassIndex(size_t bytes) noexcept {
+    return bytes <= kMinClassSize ? 0 : std::bit_width(bytes - 1) - std::countr_zero(kMinClassSize);
+}
+
+inline constexpr size_t ClassSize(size_t index) noexcept {
+    return kMinClassSize << index;
+}
+
+struct FreeBlock {
+    FreeBlock* next;
+};
+
+// Список свободных блоков одного класса
+struct FreeList {
+    void Push(void* p) noexcept {
+        head = ::new (p) FreeBlock{head};
+        ++count;
+    }
+
+    void* Pop() noexcept {
+        FreeBlock* block = head;
+        head = block->next;
+        --count;
+        return block;
+    }
+
+    // Отрезает первые n блоков в отдельный список
+    FreeList Split(size_t n) noexcept {
+        if (n == 0) {
+            return {};
+        }
+        FreeList front{head, n};
+        FreeBlock** tail = &head;
+        for (size_t i = 0; i < n; ++i) {
+            tail = &(*tail)->next;
+        }
+        head = *tail;
+        *tail = nullptr;
+        count -= n;
+        return front;
+    }
+
+    // Присоединяет other в начало списка
+    void Splice(FreeList other) noexcept {
+        if (other.head == nullptr) {
+            return;
+        }
+        FreeBlock* last = other.head;
+        while (last->next != nullptr) {
+            last = last->next;
+        }
+        last->next = head;
+        head = other.head;
+        count += other.count;
+    }
+
+    void DeleteAll() noexcept {
+        while (head != nullptr) {
+            ::operator delete(std::exchange(head, head->next));
+        }
+        count = 0;
+    }
+
+    FreeBlock* head = nullptr;
+    size_t count = 0;
+};
+
+// Общее хранилище блоков, которыми обмениваются кеши потоков
+class Depot {
+public:
+    static constexpr size_t kDefaultLimit = size_t{64} << 20;
+
+    // Хранилище не разрушается: потоки могут сбрасывать в него кеши и после выхода из main
+    static Depot& Instance() {
+        static Depot* depot = new Depot();
+        return *depot;
+    }
+
+    // Принимает блоки класса index. Если хранилище превысит лимит, блоки освобождаются
+    void Put(size_t index, FreeList blocks) noexcept {
+        const size_t bytes = blocks.count * ClassSize(index);
+        if (bytes_.load(std::memory_order_relaxed) + bytes > limit_.load(std::memory_order_relaxed)) {
+            blocks.DeleteAll();
+            return;
+        }
+        bytes_.fetch_add(bytes, std::memory_order_relaxed);
+        std::lock_guard lock(lists_[index].mutex);
+        lists_[index].blocks.Splice(blocks);
+    }
+
+    // Забирает до n блоков класса index
+    FreeList Take(size_t index, size_t n) noexcept {
+        FreeList taken;
+        {
+            std::lock_guard lock(lists_[index].mutex);
+            FreeList& blocks = lists_[index].blocks;
+            taken = blocks.Split(std::min(n, blocks.count));
+        }
+        bytes_.fetch_sub(taken.count * ClassSize(index), std::memory_order_relaxed);
+        return taken;
+    }
+
+    // Освобождает все хранящиеся блоки
+    void Trim() noexcept {
+        for (size_t index = 0; index < kClassCount; ++index) {
+            FreeList blocks;
+            {
+                std::lock_guard lock(lists_[index].mutex);
+                blocks = std::exchange(lists_[index].blocks, FreeList{});
+            }
+            bytes_.fetch_sub(blocks.count * ClassSize(index), std::memory_order_relaxed);
+            blocks.DeleteAll();
+        }
+    }
+
+    void SetLimit(size_t bytes) noexcept {
+        limit_.store(bytes, std::memory_order_relaxed);
+    }
+
+    size_t Bytes() const noexcept {
+        return bytes_.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct alignas(kCacheLineSize) Shard {
+        std::mutex mutex;
+        FreeList blocks;
+    };
+
+    Depot() = default;
+
+    Shard lists_[kClassCount];
+    std::atomic<size_t> bytes_ = 0;
+    std::atomic<size_t> limit_ = kDefaultLimit;
+};
+
+// Кеш свободных блоков текущего потока
+class ThreadCache {
+public:
+    static constexpr size_t kDefaultLimit = size_t{4} << 20;
+    // Объём, которым кеш обменивается с хранилищем за раз
+    static constexpr size_t kBatchBytes = size_t{64} << 10;
+
+    // Выделяет блок класса index из кеша текущего потока
+    static void* AllocateBlock(size_t index) {
+        if (exited_) {
+            return ::operator new(ClassSize(index));
+        }
+        return Current().Allocate(index);
+    }
+
+    // Возвращает блок в кеш текущего потока. После разрушения кеша при завершении потока
+    // (из деструкторов других thread_local объектов) блок уходит прямо в хранилище
+    static void DeallocateBlock(void* p, size_t index) noexcept {
+        if (exited_) {
+            FreeList block;
+            block.Push(p);
+            Depot::Instance().Put(index, block);
+            return;
+        }
+        Current().Deallocate(p, index);
+    }
+
+    static void FlushCurrent() noexcept {
+        if (!exited_) {
+            Current().Flush();
+        }
+    }
+
+    // Предел объёма кеша каждого потока
+    static inline std::atomic<size_t> limit = kDefaultLimit;
+
+private:
+    static ThreadCache& Current() {
+        thread_local ThreadCache cache;
+        return cache;
+    }
+
+    ThreadCache() = default;
+
+    ~ThreadCache() {
+        Flush();
+        exited_ = true;
+    }
+
+    void* Allocate(size_t index) {
+        FreeList& blocks = lists_[index];
+        if (blocks.count == 0) {
+            blocks.Splice(Depot::Instance().Take(index, BatchCount(index)));
+            bytes_ += blocks.count * ClassSize(index);
+        }
+        if (blocks.count == 0) {
+            return ::operator new(ClassSize(index));
+        }
+        bytes_ -= ClassSize(index);
+        return blocks.Pop();
+    }
+
+    void Deallocate(void* p, size_t index) noexcept {
+        FreeList& blocks = lists_[index];
+        blocks.Push(p);
+        bytes_ += ClassSize(index);
+        if (bytes_ > limit.load(std::memory_order_relaxed)) {
+            // Половина списка уходит в хранилище, остальное остаётся для повторных выделений
+            const size_t n = std::max<size_t>(blocks.count / 2, 1);
+            bytes_ -= n * ClassSize(index);
+            Depot::Instance().Put(index, blocks.Split(n));
+        }
+    }
+
+    // Отдаёт все блоки кеша в хранилище
+    void Flush() noexcept {
+        for (size_t index = 0; index < kClassCount; ++index) {
+            if (lists_[index].count != 0) {
+                Depot::Instance().Put(index, std::exchange(lists_[index], FreeList{}));
+            }
+        }
+        bytes_ = 0;
+    }
+
+    static size_t BatchCount(size_t index) noexcept {
+        return std::max<size_t>(kBatchBytes / ClassSize(index), 1);
+    }
+
+    static inline thread_local bool exited_ = false;
+
+    FreeList lists_[kClassCount];
+    size_t bytes_ = 0;
+};
+
+}  // namespace vector_pool
+
+// Аллокатор поверх пула классов размеров. allocate_at_least отдаёт весь блок класса,
+// поэтому вместимость Vector сразу растёт до степени двойки байт. Блоки больше 1 МиБ
+// выделяются и освобождаются напрямую через operator new/delete
+template <typename T>
+class PoolAllocator {
+    static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "operator new does not guarantee alignment of T");
+
+public:
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    PoolAllocator() noexcept = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        return allocate_at_least(n).ptr;
+    }
+
+    AllocationResult<T> allocate_at_least(size_t n) {
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        const size_t bytes = n * sizeof(T);
+        if (bytes > vector_pool::kMaxClassSize) {
+            return {static_cast<T*>(::operator new(bytes)), n};
+        }
+        const size_t index = vector_pool::ClassIndex(bytes);
+        return {static_cast<T*>(vector_pool::ThreadCache::AllocateBlock(index)),
+                vector_pool::ClassSize(index) / sizeof(T)};
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        const size_t bytes = n * sizeof(T);
+        if (bytes > vector_pool::kMaxClassSize) {
+            ::operator delete(p);
+            return;
+        }
+        vector_pool::ThreadCache::DeallocateBlock(p, vector_pool::ClassIndex(bytes));
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>&) const noexcept {
+        return true;
+    }
+
+    // Возвращает в систему блоки кеша текущего потока и общего хранилища
+    static void Trim() noexcept {
+        vector_pool::ThreadCache::FlushCurrent();
+        vector_pool::Depot::Instance().Trim();
+    }
+
+    // Предел объёма кеша каждого потока в байтах
+    static void SetThreadCacheLimit(size_t bytes) noexcept {
+        vector_pool::ThreadCache::limit.store(bytes, std::memory_order_relaxed);
+    }
+
+    // Предел объёма общего хранилища в байтах, выше которого блоки освобождаются
+    static void SetDepotLimit(size_t bytes) noexcept {
+        vector_pool::Depot::Instance().SetLimit(bytes);
+    }
+};
+
+template <typename T, typename GrowthPolicy = DoublingGrowth>
+using PooledVector = Vector<T, PoolAllocator<T>, GrowthPolicy>;
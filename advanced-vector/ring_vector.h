@@ -0,0 +1,437 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+// Кольцевой буфер поверх RawMemory: элементы занимают участок буфера, который может
+// переходить через его конец. Вставка и удаление с обоих концов стоят O(1), поэтому
+// очередь не сдвигает элементы при каждом извлечении, как Erase(begin()) у Vector.
+// Элементы лежат не более чем двумя непрерывными кусками (FirstSegment и SecondSegment).
+// Только при перевыделении памяти они переносятся в начало нового буфера одним куском
+template <typename T, typename Alloc = std::allocator<T>, typename GrowthPolicy = DoublingGrowth>
+class RingVector {
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using Memory = RawMemory<T, Alloc>;
+
+    template <bool IsConst>
+    class BasicIterator;
+
+public:
+    using value_type = T;
+    using iterator = BasicIterator<false>;
+    using const_iterator = BasicIterator<true>;
+    using allocator_type = Alloc;
+
+    RingVector() = default;
+
+    explicit RingVector(const Alloc& alloc) noexcept
+        : data_(alloc) {
+    }
+
+    RingVector(const RingVector& other)
+        : data_(other.size_, AllocTraits::select_on_container_copy_construction(other.GetAllocator())) {
+        const std::span<const T> first = other.FirstSegment();
+        const std::span<const T> second = other.SecondSegment();
+        std::uninitialized_copy(first.begin(), first.end(), data_.GetAddress());
+        try {
+            std::uninitialized_copy(second.begin(), second.end(), data_ + first.size());
+        }
+        catch (...) {
+            std::destroy_n(data_.GetAddress(), first.size());
+            throw;
+        }
+        size_ = other.size_;
+    }
+
+    RingVector(RingVector&& other) noexcept
+        : data_(std::move(other.data_))
+        , head_(std::exchange(other.head_, 0))
+        , size_(std::exchange(other.size_, 0)) {
+    }
+
+    ~RingVector() {
+        Clear();
+    }
+
+    RingVector& operator=(const RingVector& rhs) {
+        if (this != &rhs) {
+            RingVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    RingVector& operator=(RingVector&& rhs) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+                                                     || AllocTraits::is_always_equal::value) {
+        if (this != &rhs) {
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value
+                          || AllocTraits::is_always_equal::value) {
+                StealFrom(rhs);
+            }
+            else if (GetAllocator() == rhs.GetAllocator()) {
+                StealFrom(rhs);
+            }
+            else if (rhs.size_ > Capacity()) {
+                // Буфер rhs забрать нельзя: перемещаем элементы поштучно в память своего аллокатора
+                Memory new_data(rhs.size_, data_.GetAllocator());
+                rhs.MoveTo(new_data.GetAddress());
+                Clear();
+                data_.Swap(new_data);
+                size_ = rhs.size_;
+                rhs.Clear();
+            }
+            else {
+                Clear();
+                rhs.MoveTo(data_.GetAddress());
+                size_ = rhs.size_;
+                rhs.Clear();
+            }
+        }
+        return *this;
+    }
+
+    // Обмен разрешён, только если аллокаторы распространяются при обмене или равны
+    void Swap(RingVector& other) noexcept {
+        ADVANCED_VECTOR_CHECK(AllocTraits::propagate_on_container_swap::value || GetAllocator() == other.GetAllocator());
+        data_.Swap(other.data_);
+        std::swap(head_, other.head_);
+        std::swap(size_, other.size_);
+    }
+
+    Alloc GetAllocator() const noexcept {
+        return data_.GetAllocator();
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return data_.Capacity();
+    }
+
+    // Переносит элементы в начало нового буфера, если вместимость меньше new_capacity
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= Capacity()) {
+            return;
+        }
+        Memory new_data(new_capacity, data_.GetAllocator());
+        RelocateTo(new_data.GetAddress());
+        data_.Swap(new_data);
+        head_ = 0;
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return data_[Slot(index)];
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<RingVector&>(*this)[index];
+    }
+
+    T& Front() noexcept {
+        return (*this)[0];
+    }
+
+    const T& Front() const noexcept {
+        return (*this)[0];
+    }
+
+    T& Back() noexcept {
+        return (*this)[size_ - 1];
+    }
+
+    const T& Back() const noexcept {
+        return (*this)[size_ - 1];
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    void PushFront(const T& value) {
+        EmplaceFront(value);
+    }
+
+    void PushFront(T&& value) {
+        EmplaceFront(std::move(value));
+    }
+
+    // Аргументы могут ссылаться на элементы этого же вектора: при росте новый элемент
+    // строится до переноса старых
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (size_ == Capacity()) {
+            return EmplaceGrow(size_, std::forward<Args>(args)...);
+        }
+        T* slot = std::construct_at(data_ + Slot(size_), std::forward<Args>(args)...);
+        ++size_;
+        return *slot;
+    }
+
+    template <typename... Args>
+    T& EmplaceFront(Args&&... args) {
+        if (size_ == Capacity()) {
+            return EmplaceGrow(0, std::forward<Args>(args)...);
+        }
+        const size_t head = head_ == 0 ? Capacity() - 1 : head_ - 1;
+        T* slot = std::construct_at(data_ + head, std::forward<Args>(args)...);
+        head_ = head;
+        ++size_;
+        return *slot;
+    }
+
+    void PopFront() noexcept {
+        assert(size_ > 0);
+        std::destroy_at(data_ + head_);
+        --size_;
+        // Опустевшая очередь снова начинается с начала буфера и дольше не разрывается
+        head_ = size_ == 0 || head_ + 1 == Capacity() ? 0 : head_ + 1;
+    }
+
+    void PopBack() noexcept {
+        assert(size_ > 0);
+        std::destroy_at(data_ + Slot(size_ - 1));
+        if (--size_ == 0) {
+            head_ = 0;
+        }
+    }
+
+    // Уничтожает все элементы, сохраняя буфер
+    void Clear() noexcept {
+        const std::span<T> first = FirstSegment();
+        const std::span<T> second = SecondSegment();
+        std::destroy(first.begin(), first.end());
+        std::destroy(second.begin(), second.end());
+        head_ = size_ = 0;
+    }
+
+    // Начало последовательности: элементы от первого до конца буфера или до последнего элемента
+    std::span<T> FirstSegment() noexcept {
+        return {data_ + head_, std::min(size_, Capacity() - head_)};
+    }
+
+    std::span<const T> FirstSegment() const noexcept {
+        return const_cast<RingVector&>(*this).FirstSegment();
+    }
+
+    // Продолжение последовательности с начала буфера. Пусто, если элементы не разрываются
+    std::span<T> SecondSegment() noexcept {
+        return {data_.GetAddress(), size_ - FirstSegment().size()};
+    }
+
+    std::span<const T> SecondSegment() const noexcept {
+        return const_cast<RingVector&>(*this).SecondSegment();
+    }
+
+    // Собирает элементы в один непрерывный кусок. Если они разорваны, переносит их
+    // в новый буфер той же вместимости
+    std::span<T> Linearize() {
+        if (!SecondSegment().empty()) {
+            Memory new_data(Capacity(), data_.GetAllocator());
+            RelocateTo(new_data.GetAddress());
+            data_.Swap(new_data);
+            head_ = 0;
+        }
+        return FirstSegment();
+    }
+
+    iterator begin() noexcept {
+        return {this, 0};
+    }
+
+    iterator end() noexcept {
+        return {this, size_};
+    }
+
+    const_iterator begin() const noexcept {
+        return {this, 0};
+    }
+
+    const_iterator end() const noexcept {
+        return {this, size_};
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    size_t Slot(size_t index) const noexcept {
+        const size_t slot = head_ + index;
+        return slot < Capacity() ? slot : slot - Capacity();
+    }
+
+    // Выделяет буфер побольше, строит в нём новый элемент с индексом index (0 или size_)
+    // и переносит за ним остальные
+    template <typename... Args>
+    T& EmplaceGrow(size_t index, Args&&... args) {
+        Memory new_data(GrowthPolicy::NextCapacity(Capacity(), size_ + 1, sizeof(T)), data_.GetAllocator());
+        T* slot = std::construct_at(new_data + index, std::forward<Args>(args)...);
+        try {
+            RelocateTo(new_data + (index == 0 ? 1 : 0));
+        }
+        catch (...) {
+            std::destroy_at(slot);
+            throw;
+        }
+        data_.Swap(new_data);
+        head_ = 0;
+        ++size_;
+        return *slot;
+    }
+
+    // Переносит элементы по порядку в неинициализированную память dest так же, как Vector
+    // (см. vector_uninitialized::RelocateN). Если копирование бросит исключение, вектор не изменится
+    void RelocateTo(T* dest) {
+        const std::span<T> first = FirstSegment();
+        const std::span<T> second = SecondSegment();
+        vector_uninitialized::RelocateN(first.data(), first.size(), dest);
+        try {
+            vector_uninitialized::RelocateN(second.data(), second.size(), dest + first.size());
+        }
+        catch (...) {
+            std::destroy_n(dest, first.size());
+            throw;
+        }
+        vector_uninitialized::DestroyRelocated(first.data(), first.size());
+        vector_uninitialized::DestroyRelocated(second.data(), second.size());
+    }
+
+    // Перемещает элементы по порядку в неинициализированную память dest, не разрушая исходные.
+    // Если перемещение бросит исключение, уже построенные в dest элементы разрушаются
+    void MoveTo(T* dest) {
+        const std::span<T> first = FirstSegment();
+        const std::span<T> second = SecondSegment();
+        vector_uninitialized::MoveN(first.data(), first.size(), dest);
+        try {
+            vector_uninitialized::MoveN(second.data(), second.size(), dest + first.size());
+        }
+        catch (...) {
+            std::destroy_n(dest, first.size());
+            throw;
+        }
+    }
+
+    // Уничтожает свои элементы и забирает буфер rhs вместе с его элементами
+    void StealFrom(RingVector& rhs) noexcept {
+        Clear();
+        data_ = std::move(rhs.data_);
+        head_ = std::exchange(rhs.head_, 0);
+        size_ = std::exchange(rhs.size_, 0);
+    }
+
+    Memory data_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+};
+
+// Итератор произвольного доступа, хранящий индекс элемента от начала очереди
+template <typename T, typename Alloc, typename GrowthPolicy>
+template <bool IsConst>
+class RingVector<T, Alloc, GrowthPolicy>::BasicIterator {
+    using Owner = std::conditional_t<IsConst, const RingVector, RingVector>;
+
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<IsConst, const T*, T*>;
+    using reference = std::conditional_t<IsConst, const T&, T&>;
+
+    BasicIterator() = default;
+
+    BasicIterator(Owner* owner, size_t index) noexcept
+        : owner_(owner)
+        , index_(index) {
+    }
+
+    operator BasicIterator<true>() const noexcept requires(!IsConst) {
+        return {owner_, index_};
+    }
+
+    reference operator*() const noexcept {
+        return (*owner_)[index_];
+    }
+
+    pointer operator->() const noexcept {
+        return &(*owner_)[index_];
+    }
+
+    reference operator[](difference_type offset) const noexcept {
+        return (*owner_)[index_ + offset];
+    }
+
+    BasicIterator& operator++() noexcept {
+        ++index_;
+        return *this;
+    }
+
+    BasicIterator operator++(int) noexcept {
+        return {owner_, index_++};
+    }
+
+    BasicIterator& operator--() noexcept {
+        --index_;
+        return *this;
+    }
+
+    BasicIterator operator--(int) noexcept {
+        return {owner_, index_--};
+    }
+
+    BasicIterator& operator+=(difference_type offset) noexcept {
+        index_ += offset;
+        return *this;
+    }
+
+    BasicIterator& operator-=(difference_type offset) noexcept {
+        index_ -= offset;
+        return *this;
+    }
+
+    friend BasicIterator operator+(BasicIterator it, difference_type offset) noexcept {
+        return it += offset;
+    }
+
+    friend BasicIterator operator+(difference_type offset, BasicIterator it) noexcept {
+        return it += offset;
+    }
+
+    friend BasicIterator operator-(BasicIterator it, difference_type offset) noexcept {
+        return it -= offset;
+    }
+
+    friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+        return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+    }
+
+    friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+        return lhs.index_ == rhs.index_;
+    }
+
+    friend auto operator<=>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+        return lhs.index_ <=> rhs.index_;
+    }
+
+private:
+    Owner* owner_ = nullptr;
+    size_t index_ = 0;
+};
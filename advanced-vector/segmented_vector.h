@@ -0,0 +1,305 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+// Вектор из блоков RawMemory по SegmentSize элементов. При росте добавляется новый блок,
+// а уже построенные элементы не перемещаются: указатели, ссылки и итераторы на них остаются
+// валидными до удаления самих элементов. Поэтому T не обязан быть перемещаемым.
+// Таблица блоков хранится в Vector, доступ по индексу стоит двух разыменований.
+// ForEachSegment отдаёт элементы непрерывными кусками для векторизованных циклов
+template <typename T, typename Alloc = std::allocator<T>,
+          size_t SegmentSize = std::bit_floor(std::max<size_t>(4096 / sizeof(T), 16))>
+class SegmentedVector {
+    static_assert(std::has_single_bit(SegmentSize), "SegmentSize must be a power of two");
+
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using Segment = RawMemory<T, Alloc>;
+    using SegmentTable = Vector<Segment, typename AllocTraits::template rebind_alloc<Segment>>;
+
+    template <bool IsConst>
+    class BasicIterator;
+
+public:
+    using value_type = T;
+    using iterator = BasicIterator<false>;
+    using const_iterator = BasicIterator<true>;
+    using allocator_type = Alloc;
+
+    SegmentedVector() = default;
+
+    explicit SegmentedVector(const Alloc& alloc) noexcept
+        : alloc_(alloc) {
+    }
+
+    SegmentedVector(const SegmentedVector& other)
+        : SegmentedVector(AllocTraits::select_on_container_copy_construction(other.alloc_)) {
+        // Конструктор уже делегирован, поэтому при исключении разрушитель удалит скопированное
+        Reserve(other.size_);
+        for (const T& value : other) {
+            EmplaceBack(value);
+        }
+    }
+
+    SegmentedVector(SegmentedVector&& other) noexcept
+        : segments_(std::move(other.segments_))
+        , size_(std::exchange(other.size_, 0))
+        , alloc_(other.alloc_) {
+    }
+
+    ~SegmentedVector() {
+        Clear();
+    }
+
+    SegmentedVector& operator=(const SegmentedVector& rhs) {
+        if (this != &rhs) {
+            SegmentedVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    // Блоки переходят вместе со своими аллокаторами, поэтому аллокатор для новых блоков
+    // заменяется только при propagate_on_container_move_assignment. Если аллокаторы не равны,
+    // таблица блоков переносится поэлементно в новую память и может бросить std::bad_alloc
+    SegmentedVector& operator=(SegmentedVector&& rhs) noexcept(AllocTraits::propagate_on_container_move_assignment::value
+                                                               || AllocTraits::is_always_equal::value) {
+        if (this != &rhs) {
+            Clear();
+            segments_ = std::move(rhs.segments_);
+            size_ = std::exchange(rhs.size_, 0);
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                alloc_ = rhs.alloc_;
+            }
+        }
+        return *this;
+    }
+
+    void Swap(SegmentedVector& other) noexcept {
+        segments_.Swap(other.segments_);
+        std::swap(size_, other.size_);
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(alloc_, other.alloc_);
+        }
+    }
+
+    Alloc GetAllocator() const noexcept {
+        return alloc_;
+    }
+
+    // Выделяет блоки, пока вместимость меньше capacity
+    void Reserve(size_t capacity) {
+        segments_.Reserve((capacity + SegmentSize - 1) / SegmentSize);
+        while (Capacity() < capacity) {
+            segments_.EmplaceBack(SegmentSize, alloc_);
+        }
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return segments_.Size() * SegmentSize;
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return segments_[index / SegmentSize][index % SegmentSize];
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<SegmentedVector&>(*this)[index];
+    }
+
+    // Добавляет элемент за O(1), не перемещая существующие. Аргументы могут ссылаться
+    // на элементы этого же вектора
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (size_ == Capacity()) {
+            segments_.EmplaceBack(SegmentSize, alloc_);
+        }
+        T* slot = segments_[size_ / SegmentSize] + size_ % SegmentSize;
+        std::construct_at(slot, std::forward<Args>(args)...);
+        ++size_;
+        return *slot;
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    void PopBack() noexcept {
+        assert(size_ > 0);
+        --size_;
+        std::destroy_at(segments_[size_ / SegmentSize] + size_ % SegmentSize);
+    }
+
+    // Уничтожает все элементы, сохраняя блоки
+    void Clear() noexcept {
+        ForEachSegment([](std::span<T> segment) {
+            std::destroy(segment.begin(), segment.end());
+        });
+        size_ = 0;
+    }
+
+    // Освобождает блоки, в которых нет элементов
+    void ShrinkToFit() {
+        const size_t used = (size_ + SegmentSize - 1) / SegmentSize;
+        while (segments_.Size() > used) {
+            segments_.PopBack();
+        }
+        segments_.ShrinkToFit();
+    }
+
+    // Вызывает f(std::span<T>) для каждого занятого куска блока по порядку
+    template <typename Function>
+    void ForEachSegment(Function f) {
+        for (size_t first = 0; first < size_; first += SegmentSize) {
+            f(std::span<T>(segments_[first / SegmentSize].GetAddress(), std::min(SegmentSize, size_ - first)));
+        }
+    }
+
+    template <typename Function>
+    void ForEachSegment(Function f) const {
+        for (size_t first = 0; first < size_; first += SegmentSize) {
+            f(std::span<const T>(segments_[first / SegmentSize].GetAddress(), std::min(SegmentSize, size_ - first)));
+        }
+    }
+
+    iterator begin() noexcept {
+        return {this, 0};
+    }
+
+    iterator end() noexcept {
+        return {this, size_};
+    }
+
+    const_iterator begin() const noexcept {
+        return {this, 0};
+    }
+
+    const_iterator end() const noexcept {
+        return {this, size_};
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    SegmentTable segments_;
+    size_t size_ = 0;
+    [[no_unique_address]] Alloc alloc_;
+};
+
+// Итератор произвольного доступа, хранящий индекс элемента. Рост вектора его не инвалидирует
+template <typename T, typename Alloc, size_t SegmentSize>
+template <bool IsConst>
+class SegmentedVector<T, Alloc, SegmentSize>::BasicIterator {
+    using Owner = std::conditional_t<IsConst, const SegmentedVector, SegmentedVector>;
+
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<IsConst, const T*, T*>;
+    using reference = std::conditional_t<IsConst, const T&, T&>;
+
+    BasicIterator() = default;
+
+    BasicIterator(Owner* owner, size_t index) noexcept
+        : owner_(owner)
+        , index_(index) {
+    }
+
+    operator BasicIterator<true>() const noexcept requires(!IsConst) {
+        return {owner_, index_};
+    }
+
+    reference operator*() const noexcept {
+        return (*owner_)[index_];
+    }
+
+    pointer operator->() const noexcept {
+        return &(*owner_)[index_];
+    }
+
+    reference operator[](difference_type offset) const noexcept {
+        return (*owner_)[index_ + offset];
+    }
+
+    BasicIterator& operator++() noexcept {
+        ++index_;
+        return *this;
+    }
+
+    BasicIterator operator++(int) noexcept {
+        return {owner_, index_++};
+    }
+
+    BasicIterator& operator--() noexcept {
+        --index_;
+        return *this;
+    }
+
+    BasicIterator operator--(int) noexcept {
+        return {owner_, index_--};
+    }
+
+    BasicIterator& operator+=(difference_type offset) noexcept {
+        index_ += offset;
+        return *this;
+    }
+
+    BasicIterator& operator-=(difference_type offset) noexcept {
+        index_ -= offset;
+        return *this;
+    }
+
+    friend BasicIterator operator+(BasicIterator it, difference_type offset) noexcept {
+        return it += offset;
+    }
+
+    friend BasicIterator operator+(difference_type offset, BasicIterator it) noexcept {
+        return it += offset;
+    }
+
+    friend BasicIterator operator-(BasicIterator it, difference_type offset) noexcept {
+        return it -= offset;
+    }
+
+    friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+        return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+    }
+
+    friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+        return lhs.index_ == rhs.index_;
+    }
+
+    friend auto operator<=>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+        return lhs.index_ <=> rhs.index_;
+    }
+
+private:
+    Owner* owner_ = nullptr;
+    size_t index_ = 0;
+};
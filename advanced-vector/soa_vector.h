@@ -0,0 +1,418 @@
+#pragma once
+#include "allocators.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Ссылка на элемент SoaVector: кортеж ссылок на его поля. Присваивание пишет в поля,
+// структурное связывание и std::get работают как для std::tuple. Собственный тип нужен для
+// специализаций std::basic_common_reference ниже: с ними у ссылки и кортежа значений есть
+// общий ссылочный тип, и итераторы SoaVector удовлетворяют std::random_access_iterator
+template <typename... Refs>
+class SoaReference : public std::tuple<Refs...> {
+    using Base = std::tuple<Refs...>;
+
+public:
+    using Base::Base;
+    using Base::operator=;
+
+    // Ссылается на поля кортежа значений
+    template <typename... Us>
+        requires(sizeof...(Us) == sizeof...(Refs) && (... && std::is_constructible_v<Refs, Us&>))
+    SoaReference(std::tuple<Us...>& values) noexcept
+        : Base(std::apply([](Us&... fields) { return Base(fields...); }, values)) {
+    }
+};
+
+template <typename... Refs>
+struct std::tuple_size<SoaReference<Refs...>> : std::integral_constant<size_t, sizeof...(Refs)> {
+};
+
+template <size_t I, typename... Refs>
+struct std::tuple_element<I, SoaReference<Refs...>> : std::tuple_element<I, std::tuple<Refs...>> {
+};
+
+// Общий тип ссылки и кортежа значений — ссылка на поля с общими для них квалификаторами
+template <typename... Refs, typename... Us, template <typename> class RefQual, template <typename> class UQual>
+    requires(sizeof...(Refs) == sizeof...(Us))
+struct std::basic_common_reference<SoaReference<Refs...>, std::tuple<Us...>, RefQual, UQual> {
+    using type = SoaReference<std::common_reference_t<RefQual<Refs>, UQual<Us>>...>;
+};
+
+template <typename... Us, typename... Refs, template <typename> class UQual, template <typename> class RefQual>
+    requires(sizeof...(Refs) == sizeof...(Us))
+struct std::basic_common_reference<std::tuple<Us...>, SoaReference<Refs...>, UQual, RefQual> {
+    using type = SoaReference<std::common_reference_t<UQual<Us>, RefQual<Refs>>...>;
+};
+
+// Вектор структур, хранящийся по столбцам: каждое поле Ts лежит в своём буфере RawMemory,
+// выровненном по кеш-линии. Цикл, который читает одно-два поля, не тянет в кеш остальные,
+// а столбец целиком доступен через Column<I>() для векторизованной обработки.
+// operator[] и итераторы возвращают SoaReference — кортеж ссылок на поля элемента
+template <typename... Ts>
+class SoaVector {
+    static_assert(sizeof...(Ts) > 0, "SoaVector needs at least one field");
+    // Столбцы переносятся по очереди, поэтому исключение посреди переноса оставило бы
+    // элемент разорванным между старым и новым буферами
+    static_assert((... && (is_trivially_relocatable_v<Ts> || std::is_nothrow_move_constructible_v<Ts>)),
+                  "SoaVector fields must be nothrow move constructible");
+
+    template <typename T>
+    using ColumnMemory = RawMemory<T, AlignedAllocator<T, std::max(kCacheLineSize, alignof(T)), false>>;
+    using Columns = std::tuple<ColumnMemory<Ts>...>;
+    using Indices = std::index_sequence_for<Ts...>;
+
+    template <bool IsConst>
+    class BasicIterator;
+
+public:
+    template <size_t I>
+    using field_type = std::tuple_element_t<I, std::tuple<Ts...>>;
+    using value_type = std::tuple<Ts...>;
+    using reference = SoaReference<Ts&...>;
+    using const_reference = SoaReference<const Ts&...>;
+    using iterator = BasicIterator<false>;
+    using const_iterator = BasicIterator<true>;
+
+    SoaVector() = default;
+
+    explicit SoaVector(size_t size)
+        : columns_(ColumnMemory<Ts>(size)...) {
+        ConstructColumns(columns_, 0, size, [&](auto column) {
+            std::uninitialized_value_construct_n(Data<column>(), size);
+        });
+        size_ = size;
+    }
+
+    SoaVector(const SoaVector& other)
+        : columns_(ColumnMemory<Ts>(other.size_)...) {
+        ConstructColumns(columns_, 0, other.size_, [&](auto column) {
+            std::uninitialized_copy_n(other.Data<column>(), other.size_, Data<column>());
+        });
+        size_ = other.size_;
+    }
+
+    SoaVector(SoaVector&& other) noexcept
+        : columns_(std::move(other.columns_))
+        , size_(std::exchange(other.size_, 0)) {
+    }
+
+    ~SoaVector() {
+        DestroyColumns(columns_, 0, size_);
+    }
+
+    SoaVector& operator=(const SoaVector& rhs) {
+        if (this != &rhs) {
+            SoaVector rhs_copy(rhs);
+            Swap(rhs_copy);
+        }
+        return *this;
+    }
+
+    SoaVector& operator=(SoaVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Clear();
+            columns_ = std::move(rhs.columns_);
+            size_ = std::exchange(rhs.size_, 0);
+        }
+        return *this;
+    }
+
+    void Swap(SoaVector& other) noexcept {
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            (std::get<I>(columns_).Swap(std::get<I>(other.columns_)), ...);
+        }(Indices{});
+        std::swap(size_, other.size_);
+    }
+
+    void Reserve(size_t new_capacity) {
+        if (new_capacity <= Capacity()) {
+            return;
+        }
+        Columns new_columns{ColumnMemory<Ts>(new_capacity)...};
+        RelocateColumns(new_columns);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return std::get<0>(columns_).Capacity();
+    }
+
+    reference operator[](size_t index) noexcept {
+        assert(index < size_);
+        return [&]<size_t... I>(std::index_sequence<I...>) {
+            return reference(Data<I>()[index]...);
+        }(Indices{});
+    }
+
+    const_reference operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return [&]<size_t... I>(std::index_sequence<I...>) {
+            return const_reference(Data<I>()[index]...);
+        }(Indices{});
+    }
+
+    // Поле I элемента index
+    template <size_t I>
+    field_type<I>& Get(size_t index) noexcept {
+        assert(index < size_);
+        return Data<I>()[index];
+    }
+
+    template <size_t I>
+    const field_type<I>& Get(size_t index) const noexcept {
+        assert(index < size_);
+        return Data<I>()[index];
+    }
+
+    // Все значения поля I подряд. Начало столбца выровнено по кеш-линии
+    template <size_t I>
+    std::span<field_type<I>> Column() noexcept {
+        return {Data<I>(), size_};
+    }
+
+    template <size_t I>
+    std::span<const field_type<I>> Column() const noexcept {
+        return {Data<I>(), size_};
+    }
+
+    template <size_t I>
+    field_type<I>* Data() noexcept {
+        return std::get<I>(columns_).GetAddress();
+    }
+
+    template <size_t I>
+    const field_type<I>* Data() const noexcept {
+        return std::get<I>(columns_).GetAddress();
+    }
+
+    void Clear() noexcept {
+        DestroyColumns(columns_, 0, size_);
+        size_ = 0;
+    }
+
+    // Добавляет элемент, конструируя каждое поле из своего аргумента
+    template <typename... Args>
+    reference EmplaceBack(Args&&... args) {
+        static_assert(sizeof...(Args) == sizeof...(Ts), "EmplaceBack takes one argument per field");
+        auto field_args = std::forward_as_tuple(std::forward<Args>(args)...);
+        auto construct = [&](Columns& columns) {
+            ConstructColumns(columns, size_, 1, [&](auto column) {
+                std::construct_at(std::get<column>(columns).GetAddress() + size_,
+                                  std::get<column>(std::move(field_args)));
+            });
+        };
+        if (size_ == Capacity()) {
+            // Новый элемент строится до переноса старых, так как аргументы могут ссылаться на них
+            Columns new_columns{ColumnMemory<Ts>(CalcCapacity(size_ + 1))...};
+            construct(new_columns);
+            RelocateColumns(new_columns);
+        }
+        else {
+            construct(columns_);
+        }
+        ++size_;
+        return (*this)[size_ - 1];
+    }
+
+    void PopBack() noexcept {
+        assert(size_ > 0);
+        --size_;
+        DestroyColumns(columns_, size_, 1);
+    }
+
+    iterator Erase(const_iterator pos) noexcept(kNothrowMoveAssignable) {
+        return Erase(pos, pos + 1);
+    }
+
+    iterator Erase(const_iterator first, const_iterator last) noexcept(kNothrowMoveAssignable) {
+        assert(first.owner_ == this && first <= last && last <= cend());
+        const size_t first_idx = first.index_;
+        const size_t count = last - first;
+        if (count != 0) {
+            [&]<size_t... I>(std::index_sequence<I...>) {
+                (std::move(Data<I>() + first_idx + count, Data<I>() + size_, Data<I>() + first_idx), ...);
+            }(Indices{});
+            DestroyColumns(columns_, size_ - count, count);
+            size_ -= count;
+        }
+        return begin() + first_idx;
+    }
+
+    iterator begin() noexcept {
+        return {this, 0};
+    }
+
+    iterator end() noexcept {
+        return {this, size_};
+    }
+
+    const_iterator begin() const noexcept {
+        return {this, 0};
+    }
+
+    const_iterator end() const noexcept {
+        return {this, size_};
+    }
+
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+private:
+    static constexpr bool kNothrowMoveAssignable = (... && std::is_nothrow_move_assignable_v<Ts>);
+
+    size_t CalcCapacity(size_t required) const noexcept {
+        return DoublingGrowth::NextCapacity(Capacity(), required, (... + sizeof(Ts)));
+    }
+
+    // Вызывает construct(std::integral_constant<size_t, I>) для каждого столбца по порядку.
+    // Если очередной столбец бросает исключение, count элементов с позиции offset,
+    // уже построенные в предыдущих столбцах, разрушаются
+    template <typename Construct>
+    static void ConstructColumns(Columns& columns, size_t offset, size_t count, Construct construct) {
+        size_t constructed = 0;
+        try {
+            [&]<size_t... I>(std::index_sequence<I...>) {
+                ((construct(std::integral_constant<size_t, I>{}), ++constructed), ...);
+            }(Indices{});
+        }
+        catch (...) {
+            DestroyColumns(columns, offset, count, constructed);
+            throw;
+        }
+    }
+
+    // Разрушает count элементов с позиции offset в первых column_count столбцах
+    static void DestroyColumns(Columns& columns, size_t offset, size_t count,
+                               size_t column_count = sizeof...(Ts)) noexcept {
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            ((I < column_count ? void(std::destroy_n(std::get<I>(columns).GetAddress() + offset, count)) : void()), ...);
+        }(Indices{});
+    }
+
+    // Переносит size_ элементов в new_columns и делает их своим буфером. Поля переносятся
+    // перемещением (см. static_assert в начале класса), поэтому исключений не бывает
+    void RelocateColumns(Columns& new_columns) noexcept {
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            (vector_uninitialized::RelocateN(Data<I>(), size_, std::get<I>(new_columns).GetAddress()), ...);
+            (vector_uninitialized::DestroyRelocated(Data<I>(), size_), ...);
+        }(Indices{});
+        columns_.swap(new_columns);
+    }
+
+    Columns columns_;
+    size_t size_ = 0;
+};
+
+// Итератор произвольного доступа по индексу. Разыменование даёт SoaReference, а не
+// настоящую ссылку, поэтому для алгоритмов до C++20 он лишь итератор ввода, как итераторы
+// std::views::zip
+template <typename... Ts>
+template <bool IsConst>
+class SoaVector<Ts...>::BasicIterator {
+    using Owner = std::conditional_t<IsConst, const SoaVector, SoaVector>;
+
+public:
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = SoaVector::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::conditional_t<IsConst, SoaVector::const_reference, SoaVector::reference>;
+
+    BasicIterator() = default;
+
+    BasicIterator(Owner* owner, size_t index) noexcept
+        : owner_(owner)
+        , index_(index) {
+    }
+
+    operator BasicIterator<true>() const noexcept requires(!IsConst) {
+        return {owner_, index_};
+    }
+
+    reference operator*() const noexcept {
+        return (*owner_)[index_];
+    }
+
+    reference operator[](difference_type offset) const noexcept {
+        return (*owner_)[index_ + offset];
+    }
+
+    BasicIterator& operator++() noexcept {
+        ++index_;
+        return *this;
+    }
+
+    BasicIterator operator++(int) noexcept {
+        return {owner_, index_++};
+    }
+
+    BasicIterator& operator--() noexcept {
+        --index_;
+        return *this;
+    }
+
+    BasicIterator operator--(int) noexcept {
+        return {owner_, index_--};
+    }
+
+    BasicIterator& operator+=(difference_type offset) noexcept {
+        index_ += offset;
+        return *this;
+    }
+
+    BasicIterator& operator-=(difference_type offset) noexcept {
+        index_ -= offset;
+        return *this;
+    }
+
+    friend BasicIterator operator+(BasicIterator it, difference_type offset) noexcept {
+        return it += offset;
+    }
+
+    friend BasicIterator operator+(difference_type offset, BasicIterator it) noexcept {
+        return it += offset;
+    }
+
+    friend BasicIterator operator-(BasicIterator it, difference_type offset) noexcept {
+        return it -= offset;
+    }
+
+    friend difference_type operator-(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+        return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+    }
+
+    friend bool operator==(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+        return lhs.index_ == rhs.index_;
+    }
+
+    friend auto operator<=>(const BasicIterator& lhs, const BasicIterator& rhs) noexcept {
+        return lhs.index_ <=> rhs.index_;
+    }
+
+private:
+    friend class SoaVector;
+
+    Owner* owner_ = nullptr;
+    size_t index_ = 0;
+};
+
+static_assert(std::random_access_iterator<SoaVector<int, double>::iterator>);
+static_assert(std::random_access_iterator<SoaVector<int, double>::const_iterator>);
@@ -0,0 +1,42 @@
+#pragma once
+#include "vector.h"
+
+#include <cstddef>
+#include <new>
+
+// Аллокатор, который никогда не выделяет память: allocate бросает std::bad_alloc.
+// Вектор со встроенным буфером и таким аллокатором не обращается к куче
+template <typename T>
+class NoHeapAllocator {
+public:
+    using value_type = T;
+
+    // Освобождать нечего, и Vector не вызывает deallocate
+    static constexpr bool kNoopDeallocate = true;
+
+    constexpr NoHeapAllocator() noexcept = default;
+
+    template <typename U>
+    constexpr NoHeapAllocator(const NoHeapAllocator<U>&) noexcept {
+    }
+
+    [[noreturn]] T* allocate(size_t) {
+        throw std::bad_alloc();
+    }
+
+    constexpr void deallocate(T*, size_t) noexcept {
+    }
+
+    template <typename U>
+    constexpr bool operator==(const NoHeapAllocator<U>&) const noexcept {
+        return true;
+    }
+};
+
+// Вектор фиксированной вместимости N с элементами внутри самого объекта, для кода, где
+// выделять память в куче нельзя. Операции Vector, которым не хватает N элементов
+// (EmplaceBack, Insert, Reserve, Resize), бросают std::bad_alloc и оставляют вектор
+// неизменным. Release тоже бросает исключение: буфер из кучи взять неоткуда.
+// Перемещение и обмен переносят элементы по одному, как у SmallVector
+template <typename T, size_t N>
+using StaticVector = Vector<T, NoHeapAllocator<T>, DoublingGrowth, N>;
@@ -1,306 +1,2025 @@
 #pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
 #include <cassert>
+#include <concepts>
+#include <condition_variable>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
 #include <memory>
+#include <exception>
+#include <mutex>
 #include <new>
+#include <ranges>
+#include <span>
+#include <thread>
+#include <type_traits>
 #include <utility>
 
+// Уровень проверок Vector и RawMemory. Задаётся до подключения заголовка или опцией CMake
+// ADVANCED_VECTOR_CHECK_LEVEL:
+// 0 — обычные assert, которые исчезают при NDEBUG;
+// 1 — дешёвые проверки границ и позиций, которые остаются и в release-сборке:
+//     нарушение аварийно останавливает программу инструкцией trap;
+// 2 — отладочный режим: вдобавок итераторы Vector запоминают поколение буфера
+//     и останавливают программу при обращении после перевыделения памяти
+#ifndef ADVANCED_VECTOR_CHECK_LEVEL
+#define ADVANCED_VECTOR_CHECK_LEVEL 0
+#endif
+
+#if ADVANCED_VECTOR_CHECK_LEVEL > 0
+#define ADVANCED_VECTOR_CHECK(condition) \
+    do {                                 \
+        if (!(condition)) [[unlikely]] { \
+            __builtin_trap();            \
+        }                                \
+    } while (false)
+#else
+#define ADVANCED_VECTOR_CHECK(condition) assert(condition)
+#endif
+
+// Под AddressSanitizer Vector помечает незанятую часть буфера недоступной, и чтение
+// за Size() ловится как container-overflow даже внутри выделенной памяти
+#if defined(__SANITIZE_ADDRESS__)
+#define ADVANCED_VECTOR_ANNOTATE_CONTAINER 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define ADVANCED_VECTOR_ANNOTATE_CONTAINER 1
+#endif
+#endif
+
+#ifdef ADVANCED_VECTOR_ANNOTATE_CONTAINER
+#include <sanitizer/common_interface_defs.h>
+#endif
+
+// Объекты типа T можно перенести в другую память побайтовым копированием, не вызывая
+// деструктор у исходных. Свои типы подключаются специализацией шаблона
 template <typename T>
-class RawMemory {
-public:
-    RawMemory() = default;
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {
+};
 
-    explicit RawMemory(size_t capacity)
-        : buffer_(Allocate(capacity))
-        , capacity_(capacity) {
-    }
+template <typename T, typename D>
+struct is_trivially_relocatable<std::unique_ptr<T, D>> : is_trivially_relocatable<D> {
+};
+
+template <typename T>
+struct is_trivially_relocatable<std::shared_ptr<T>> : std::true_type {
+};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+// Аллокатор умеет расширить выделенный блок на месте: expand(p, old_n, new_n) возвращает
+// true, если блок по адресу p теперь вмещает new_n элементов
+template <typename Alloc>
+concept AllocatorWithExpand = requires(Alloc& alloc, typename std::allocator_traits<Alloc>::pointer p, size_t n) {
+    { alloc.expand(p, n, n) } -> std::convertible_to<bool>;
+};
+
+// Аллокатор умеет перевыделить блок с побайтовым сохранением содержимого, как realloc:
+// reallocate(p, old_n, new_n) возвращает новый адрес или бросает исключение, не трогая старый блок
+template <typename Alloc>
+concept AllocatorWithReallocate = requires(Alloc& alloc, typename std::allocator_traits<Alloc>::pointer p, size_t n) {
+    { alloc.reallocate(p, n, n) } -> std::same_as<typename std::allocator_traits<Alloc>::pointer>;
+};
+
+// Аллокатор умеет выделить блок не меньше запрошенного и сообщить его реальную вместимость:
+// allocate_at_least(n) возвращает структуру с полями ptr и count, как std::allocation_result
+template <typename Alloc>
+concept AllocatorWithAllocateAtLeast = requires(Alloc& alloc, size_t n) {
+    { alloc.allocate_at_least(n).ptr } -> std::convertible_to<typename std::allocator_traits<Alloc>::pointer>;
+    { alloc.allocate_at_least(n).count } -> std::convertible_to<size_t>;
+};
+
+// Аллокатор освобождает память только целиком, как арена: deallocate у него ничего не делает,
+// и Vector его не вызывает. Признак задаётся членом static constexpr bool kNoopDeallocate = true
+template <typename Alloc>
+concept AllocatorWithNoopDeallocate = requires {
+    requires Alloc::kNoopDeallocate;
+};
+
+// Политики роста для Vector. NextCapacity(capacity, required, element_size) возвращает
+// новую вместимость не меньше required для буфера текущей вместимости capacity
 
-    ~RawMemory() {
-        Deallocate(buffer_);
+// Удваивает вместимость
+struct DoublingGrowth {
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t /*element_size*/) noexcept {
+        return std::max(required, capacity == 0 ? size_t{1} : capacity * 2);
     }
+};
 
-    RawMemory(const RawMemory&) = delete;
-    RawMemory& operator=(const RawMemory& rhs) = delete;
+// Увеличивает вместимость в полтора раза
+struct OneAndHalfGrowth {
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t /*element_size*/) noexcept {
+        return std::max(required, capacity + std::max(capacity / 2, size_t{1}));
+    }
+};
 
-    RawMemory(RawMemory&& other) noexcept {
-        Swap(other);
+// Сразу выделяет не меньше MinCapacity элементов, дальше растёт по политике Base
+template <size_t MinCapacity, typename Base = DoublingGrowth>
+struct MinCapacityGrowth {
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        return std::max(MinCapacity, Base::NextCapacity(capacity, required, element_size));
     }
+};
 
-    RawMemory& operator=(RawMemory&& rhs) noexcept {
-        if (this != &rhs) {
-            Swap(rhs);
+// Округляет размер буфера, выбранный политикой Base, вверх до размерного класса jemalloc:
+// кратно 16 байтам до 128 байт, дальше по четыре класса на каждую степень двойки.
+// Байты, которые аллокатор всё равно выделил бы, становятся вместимостью
+template <typename Base = DoublingGrowth>
+struct SizeClassGrowth {
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        size_t bytes = Base::NextCapacity(capacity, required, element_size) * element_size;
+        size_t step = 16;
+        if (bytes > 128) {
+            step = std::bit_floor(bytes - 1) / 4;
         }
-        return *this;
+        return (bytes + step - 1) / step * step / element_size;
     }
+};
 
-    T* operator+(size_t offset) noexcept {
-        // Разрешается получать адрес ячейки памяти, следующей за последним элементом массива
-        assert(offset <= capacity_);
-        return buffer_ + offset;
+// Растёт по политике Base, пока буфер меньше ThresholdBytes, а дальше линейно,
+// шагами по StepBytes, чтобы не держать в запасе до половины большого буфера
+template <size_t ThresholdBytes, size_t StepBytes, typename Base = DoublingGrowth>
+struct CappedLinearGrowth {
+    static constexpr size_t NextCapacity(size_t capacity, size_t required, size_t element_size) noexcept {
+        if (capacity * element_size < ThresholdBytes) {
+            return Base::NextCapacity(capacity, required, element_size);
+        }
+        return std::max(required, capacity + std::max(StepBytes / element_size, size_t{1}));
     }
+};
 
-    const T* operator+(size_t offset) const noexcept {
-        return const_cast<RawMemory&>(*this) + offset;
+// Политика сбора статистики RawMemory и Vector по умолчанию: ничего не собирает и ничего не стоит.
+// Счётчики с экспортом в систему метрик реализованы в vector_stats.h (CountingVectorStats)
+struct NoVectorStats {
+    // Выделен буфер на count элементов размером bytes байт
+    static constexpr void OnAllocate(size_t /*count*/, size_t /*bytes*/) noexcept {
     }
 
-    const T& operator[](size_t index) const noexcept {
-        return const_cast<RawMemory&>(*this)[index];
+    // Вектор перенёс свои элементы в новый буфер. Первое выделение памяти пустому вектору
+    // сюда не относится
+    static constexpr void OnRealocate() noexcept {
     }
 
-    T& operator[](size_t index) noexcept {
-        assert(index < capacity_);
-        return buffer_[index];
+    // При переносе n элементов перемещены (или скопированы побайтово)
+    static constexpr void OnMove(size_t /*n*/) noexcept {
     }
 
-    void Swap(RawMemory& other) noexcept {
-        std::swap(buffer_, other.buffer_);
-        std::swap(capacity_, other.capacity_);
+    // При переносе n элементов скопированы, потому что перемещение может бросить исключение
+    static constexpr void OnCopy(size_t /*n*/) noexcept {
     }
 
-    const T* GetAddress() const noexcept {
-        return buffer_;
+    // Уничтожен вектор из size элементов. Векторы без элементов и без буфера в куче не сообщаются
+    static constexpr void OnDestroy(size_t /*size*/) noexcept {
     }
+};
 
-    T* GetAddress() noexcept {
-        return buffer_;
+// Встроенный буфер RawMemory на N элементов. Массив в безымянном объединении не
+// инициализируется и не разрушается сам, а в отличие от массива байт позволяет строить
+// элементы и на этапе компиляции
+template <typename T, size_t N>
+struct InlineStorage {
+    constexpr InlineStorage() noexcept {
     }
 
-    size_t Capacity() const {
-        return capacity_;
+    constexpr ~InlineStorage() {
     }
 
-private:
-    // Выделяет сырую память под n элементов и возвращает указатель на неё
-    static T* Allocate(size_t n) {
-        return n != 0 ? static_cast<T*>(operator new(n * sizeof(T))) : nullptr;
+    constexpr T* Data() noexcept {
+        return elements;
     }
 
-    // Освобождает сырую память, выделенную ранее по адресу buf при помощи Allocate
-    static void Deallocate(T* buf) noexcept {
-        operator delete(buf);
+    constexpr const T* Data() const noexcept {
+        return elements;
     }
 
-    T* buffer_ = nullptr;
-    size_t capacity_ = 0;
+    union {
+        T elements[N];
+    };
 };
 
 template <typename T>
-class Vector {
+struct InlineStorage<T, 0> {
+    constexpr T* Data() noexcept {
+        return nullptr;
+    }
+
+    constexpr const T* Data() const noexcept {
+        return nullptr;
+    }
+};
+
+// Растёт по политике Base, а после PopBack и Erase уменьшает вместимость вдвое,
+// когда элементов становится меньше четверти вместимости
+template <typename Base = DoublingGrowth>
+struct ShrinkingGrowth : Base {
+    static constexpr bool kShrinkOnErase = true;
+};
+
+// Сырая память под элементы типа T, выделяемая аллокатором Alloc.
+// При перемещающем присваивании и обмене аллокатор передаётся вместе с буфером,
+// только если этого требуют propagate_on_container_*. Иначе аллокаторы обязаны быть равны:
+// за этим следит Vector.
+// При InlineCapacity > 0 память вместимостью до InlineCapacity элементов берётся из встроенного
+// буфера, а в куче выделяются только буферы большего размера. Встроенный буфер нельзя передать
+// другому объекту: при перемещении и обмене его содержимое не переносится
+template <typename T, typename Alloc = std::allocator<T>, size_t InlineCapacity = 0, typename Stats = NoVectorStats>
+class RawMemory {
+    using AllocTraits = std::allocator_traits<Alloc>;
+
 public:
-    using iterator = T*;
-    using const_iterator = const T*;
+    using allocator_type = Alloc;
 
-    Vector() = default;
+    RawMemory() = default;
 
-    explicit Vector(size_t size)
-        : data_(size)
-        , size_(size) {
-        std::uninitialized_value_construct_n(begin(), size);
+    constexpr explicit RawMemory(const Alloc& alloc) noexcept
+        : alloc_(alloc) {
     }
 
-    ~Vector() {
-        std::destroy_n(begin(), size_);
+    constexpr explicit RawMemory(size_t capacity, const Alloc& alloc = Alloc())
+        : alloc_(alloc) {
+        if (capacity > InlineCapacity) {
+            buffer_ = Allocate(capacity);
+            capacity_ = capacity;
+        }
     }
 
-    Vector(const Vector& other)
-        : data_(other.size_)
-        , size_(other.size_) {
-        std::uninitialized_copy_n(other.begin(), size_, begin());
+    constexpr ~RawMemory() {
+        Deallocate(buffer_, capacity_);
+    }
+
+    RawMemory(const RawMemory&) = delete;
+    RawMemory& operator=(const RawMemory& rhs) = delete;
+
+    constexpr RawMemory(RawMemory&& other) noexcept
+        : alloc_(std::move(other.alloc_)) {
+        if (!other.IsInline()) {
+            buffer_ = std::exchange(other.buffer_, other.inline_.Data());
+            capacity_ = std::exchange(other.capacity_, InlineCapacity);
+        }
     }
 
-    Vector& operator=(const Vector& rhs) {
+    constexpr RawMemory& operator=(RawMemory&& rhs) noexcept {
         if (this != &rhs) {
-            if (rhs.size_ > data_.Capacity()) {
-                Vector rhs_copy(rhs);
-                Swap(rhs_copy);
+            Deallocate(buffer_, capacity_);
+            if (rhs.IsInline()) {
+                buffer_ = inline_.Data();
+                capacity_ = InlineCapacity;
             }
             else {
-                AllocateOnCapacity(rhs);
+                buffer_ = std::exchange(rhs.buffer_, rhs.inline_.Data());
+                capacity_ = std::exchange(rhs.capacity_, InlineCapacity);
+            }
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value) {
+                alloc_ = std::move(rhs.alloc_);
             }
         }
         return *this;
     }
 
-    Vector(Vector&& other) noexcept
-        : data_(std::move(other.data_))
-        , size_(std::exchange(other.size_, 0)) {
+    constexpr T* operator+(size_t offset) noexcept {
+        // Разрешается получать адрес ячейки памяти, следующей за последним элементом массива
+        ADVANCED_VECTOR_CHECK(offset <= capacity_);
+        return buffer_ + offset;
     }
 
-    Vector& operator=(Vector&& rhs) noexcept {
-        if (this != &rhs) {
-            Swap(rhs);
-        }
-        return *this;
+    constexpr const T* operator+(size_t offset) const noexcept {
+        return const_cast<RawMemory&>(*this) + offset;
     }
 
-    void Swap(Vector& other) noexcept {
-        std::swap(data_, other.data_);
-        std::swap(size_, other.size_);
+    constexpr const T& operator[](size_t index) const noexcept {
+        return const_cast<RawMemory&>(*this)[index];
     }
 
-    void Reserve(size_t new_capacity) {
-        if (new_capacity <= data_.Capacity()) {
-            return;
+    constexpr T& operator[](size_t index) noexcept {
+        ADVANCED_VECTOR_CHECK(index < capacity_);
+        return buffer_[index];
+    }
+
+    constexpr void Swap(RawMemory& other) noexcept {
+        using std::swap;
+        const bool this_inline = IsInline();
+        const bool other_inline = other.IsInline();
+        swap(buffer_, other.buffer_);
+        swap(capacity_, other.capacity_);
+        if (other_inline) {
+            buffer_ = inline_.Data();
         }
-        RawMemory<T> new_data(new_capacity);
-        // constexpr оператор if будет вычислен во время компиляции
-        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-            std::uninitialized_move_n(begin(), size_, new_data.GetAddress());
+        if (this_inline) {
+            other.buffer_ = other.inline_.Data();
         }
-        else {
-            std::uninitialized_copy_n(begin(), size_, new_data.GetAddress());
+        if constexpr (AllocTraits::propagate_on_container_swap::value) {
+            swap(alloc_, other.alloc_);
         }
-        std::destroy_n(begin(), size_);
-        data_.Swap(new_data);
     }
 
-    size_t Size() const noexcept {
-        return size_;
+    // Пытается расширить буфер на месте до new_capacity элементов, не перемещая его
+    constexpr bool TryExpand(size_t new_capacity) noexcept {
+        if constexpr (AllocatorWithExpand<Alloc>) {
+            if (buffer_ != nullptr && !IsInline() && alloc_.expand(buffer_, capacity_, new_capacity)) {
+                capacity_ = new_capacity;
+                return true;
+            }
+        }
+        return false;
     }
 
-    size_t Capacity() const noexcept {
-        return data_.Capacity();
+    // Перевыделяет буфер под new_capacity элементов, копируя содержимое побайтово.
+    // Годится только для тривиально перемещаемых T
+    constexpr void Reallocate(size_t new_capacity) requires AllocatorWithReallocate<Alloc> {
+        static_assert(is_trivially_relocatable_v<T>);
+        if (IsInline()) {
+            T* buffer = Allocate(new_capacity);
+            std::memcpy(static_cast<void*>(buffer), static_cast<const void*>(buffer_), capacity_ * sizeof(T));
+            buffer_ = buffer;
+        }
+        else {
+            buffer_ = alloc_.reallocate(buffer_, capacity_, new_capacity);
+            Stats::OnAllocate(new_capacity, new_capacity * sizeof(T));
+        }
+        capacity_ = new_capacity;
     }
 
-    const T& operator[](size_t index) const noexcept {
-        return const_cast<Vector&>(*this)[index];
+    // Выделяет в куче буфер не меньше чем на capacity элементов, даже если они поместились бы
+    // во встроенный. Прежний буфер освобождается, поэтому в нём не должно быть элементов
+    constexpr void AllocateOnHeap(size_t capacity) {
+        T* buffer = Allocate(capacity);
+        Deallocate(buffer_, capacity_);
+        buffer_ = buffer;
+        capacity_ = capacity;
     }
 
-    T& operator[](size_t index) noexcept {
-        assert(index < size_);
-        return data_[index];
+    // Передаёт буфер из кучи вызывающему, не освобождая его. Сам объект остаётся без памяти
+    constexpr T* Release() noexcept {
+        ADVANCED_VECTOR_CHECK(!IsInline());
+        capacity_ = InlineCapacity;
+        return std::exchange(buffer_, inline_.Data());
     }
 
-    void Resize(size_t new_size) {
-        if (new_size < size_) {
-            std::destroy_n(begin() + new_size, size_ - new_size);
+    // Освобождает свой буфер и забирает буфер на capacity элементов, выделенный аллокатором,
+    // равным GetAllocator()
+    constexpr void Adopt(T* buffer, size_t capacity) noexcept {
+        Deallocate(buffer_, capacity_);
+        if (buffer == nullptr) {
+            buffer_ = inline_.Data();
+            capacity_ = InlineCapacity;
         }
-        else if (new_size > size_) {
-            Reserve(new_size);
-            std::uninitialized_value_construct_n(end(), new_size - size_);
+        else {
+            buffer_ = buffer;
+            capacity_ = capacity;
         }
-        size_ = new_size;
     }
 
-    void PushBack(const T& value) {
-        EmplaceBack(value);
+    // Освобождает буфер и заменяет аллокатор на alloc
+    constexpr void Reset(const Alloc& alloc) noexcept {
+        Deallocate(buffer_, capacity_);
+        buffer_ = inline_.Data();
+        capacity_ = InlineCapacity;
+        alloc_ = alloc;
     }
 
-    void PushBack(T&& value) {
-        EmplaceBack(std::move(value));
+    constexpr const Alloc& GetAllocator() const noexcept {
+        return alloc_;
     }
 
-    void PopBack() noexcept {
-        assert(size_ != 0);
-        --size_;
-        std::destroy_at(end());
+    constexpr const T* GetAddress() const noexcept {
+        return buffer_;
     }
 
-    template<typename... Args>
-    T& EmplaceBack(Args&&... args) {
-        return *Emplace(end(), std::forward<Args>(args)...);
+    constexpr T* GetAddress() noexcept {
+        return buffer_;
     }
 
-    template<typename... Args>
-    iterator Emplace(const_iterator pos, Args&&... args) {
-        assert(pos >= begin() && pos <= end());
-        if (size_ == data_.Capacity()) {
-            return Realocate(pos, std::forward<Args>(args)...);
+    constexpr size_t Capacity() const {
+        return capacity_;
+    }
+
+    // Память взята из встроенного буфера
+    constexpr bool IsInline() const noexcept {
+        if constexpr (InlineCapacity > 0) {
+            return buffer_ == inline_.Data();
+        }
+        else {
+            return false;
+        }
+    }
+
+private:
+    // Выделяет сырую память под n элементов и возвращает указатель на неё. Если аллокатор
+    // сообщает реальную вместимость блока, n увеличивается до неё
+    constexpr T* Allocate(size_t& n) {
+        if (n == 0) {
+            return nullptr;
         }
-        auto ptr = iterator(pos);
-        if (ptr == end()) {
-            std::construct_at(ptr, std::forward<Args>(args)...);
+        T* buffer;
+        if constexpr (AllocatorWithAllocateAtLeast<Alloc>) {
+            auto result = alloc_.allocate_at_least(n);
+            n = result.count;
+            buffer = result.ptr;
         }
         else {
-            T tmp(std::forward<Args>(args)...);
-            std::construct_at(end(), std::move(data_[size_ - 1]));
-            std::move_backward(ptr, end() - 1, end());
-            *ptr = std::move(tmp);
+            buffer = AllocTraits::allocate(alloc_, n);
         }
-        ++size_;
-        return ptr;
+        Stats::OnAllocate(n, n * sizeof(T));
+        return buffer;
     }
 
-    iterator Insert(const_iterator pos, const T& value) {
-        return Emplace(pos, value);
+    // Освобождает сырую память под n элементов, выделенную ранее по адресу buf при помощи Allocate.
+    // Встроенный буфер не освобождается
+    constexpr void Deallocate(T* buf, size_t n) noexcept {
+        if constexpr (!AllocatorWithNoopDeallocate<Alloc>) {
+            if (buf != nullptr && buf != inline_.Data()) {
+                AllocTraits::deallocate(alloc_, buf, n);
+            }
+        }
     }
 
-    iterator Insert(const_iterator pos, T&& value) {
-        return Emplace(pos, std::move(value));
+    [[no_unique_address]] InlineStorage<T, InlineCapacity> inline_;
+    T* buffer_ = inline_.Data();
+    size_t capacity_ = InlineCapacity;
+    [[no_unique_address]] Alloc alloc_;
+};
+
+// Тег конструктора Vector, который инициализирует элементы по умолчанию, а не значением.
+// Элементы тривиальных типов тогда не обнуляются
+struct DefaultInitTag {
+    explicit DefaultInitTag() = default;
+};
+
+inline constexpr DefaultInitTag default_init{};
+
+// Буфер, владение которым передаётся из Vector::Release в Vector::Adopt или вызывающему коду.
+// Первые size элементов построены, блок на capacity элементов выделен аллокатором вектора
+template <typename T>
+struct VectorBuffer {
+    T* data;
+    size_t size;
+    size_t capacity;
+};
+
+// Тег перегрузок Vector, которые распределяют копирование, перенос и разрушение элементов
+// по потокам. Куски выполняют вызывающий поток и потоки общего пула vector_parallel::ThreadPool,
+// который запускается при первом таком вызове и живёт до конца программы. Сам вызов стоит
+// выделения памяти под задание и пробуждения потоков пула. Окупается на векторах из миллионов
+// элементов с нетривиальным копированием
+struct ParallelTag {
+    explicit ParallelTag() = default;
+};
+
+inline constexpr ParallelTag parallel{};
+
+namespace vector_parallel {
+
+// Кусок меньше этого числа элементов не стоит отдельного потока
+inline constexpr size_t kMinChunkSize = size_t{1} << 15;
+
+// Начало куска index при делении n элементов на chunks почти равных кусков
+inline size_t ChunkBegin(size_t n, size_t chunks, size_t index) noexcept {
+    return n / chunks * index + std::min(index, n % chunks);
+}
+
+// Задание из chunks кусков, которые по одному разбирают вызывающий поток и свободные потоки пула
+class ChunkJob {
+public:
+    using RunChunk = void (*)(void* context, size_t index) noexcept;
+
+    ChunkJob(size_t chunks, RunChunk run, void* context) noexcept
+        : run_(run)
+        , context_(context)
+        , chunks_(chunks)
+        , remaining_(chunks) {
     }
 
-    iterator Erase(const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>) {
-        assert(pos >= begin() && pos < end());
-        auto ptr = iterator(pos);
-        if (size_) {
-            std::move(ptr + 1, end(), ptr);
-            PopBack();
+    // Выполняет следующий свободный кусок. Возвращает false, если свободных кусков не осталось
+    bool RunNext() noexcept {
+        const size_t index = next_.fetch_add(1, std::memory_order_relaxed);
+        if (index >= chunks_) {
+            return false;
         }
-        return ptr;
+        run_(context_, index);
+        // acq_rel: результаты куска видны тому, кто дождался окончания задания в Wait
+        if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard lock(mutex_);
+            done_.notify_all();
+        }
+        return true;
     }
 
-    iterator begin() noexcept {
-        return data_.GetAddress();
+    // Ждёт окончания кусков, которые ещё выполняются в других потоках
+    void Wait() noexcept {
+        std::unique_lock lock(mutex_);
+        done_.wait(lock, [this] {
+            return remaining_.load(std::memory_order_acquire) == 0;
+        });
     }
 
-    iterator end() noexcept {
-        return begin() + size_;
-    }
+private:
+    RunChunk run_;
+    void* context_;
+    size_t chunks_;
+    std::atomic<size_t> next_ = 0;
+    std::atomic<size_t> remaining_;
+    std::mutex mutex_;
+    std::condition_variable done_;
+};
 
-    const_iterator begin() const noexcept {
-        return data_.GetAddress();
+// Общий пул из hardware_concurrency() - 1 потоков: ещё один кусок выполняет вызывающий поток.
+// Вызывающий поток не ждёт, пока пул возьмёт его куски, а разбирает их сам, поэтому
+// вложенные вызовы из кусков не блокируют друг друга, даже когда все потоки пула заняты
+class ThreadPool {
+public:
+    static ThreadPool& Instance() noexcept {
+        static ThreadPool pool;
+        return pool;
     }
 
-    const_iterator end() const noexcept {
-        return begin() + size_;
-    }
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
 
-    const_iterator cbegin() const noexcept {
-        return begin();
+    // Сколько потоков, включая вызывающий, может одновременно выполнять куски
+    size_t Concurrency() const noexcept {
+        return worker_count_ + 1;
     }
 
-    const_iterator cend() const noexcept {
-        return end();
+    // Вызывает run(index) для каждого index из [0, chunks) и возвращается, когда все куски
+    // выполнены. Если задание не удалось создать, все куски выполняются в вызывающем потоке
+    template <typename Run>
+    void ForEach(size_t chunks, Run& run) noexcept {
+        std::shared_ptr<ChunkJob> job;
+        try {
+            job = std::make_shared<ChunkJob>(
+                chunks,
+                [](void* context, size_t index) noexcept {
+                    (*static_cast<Run*>(context))(index);
+                },
+                std::addressof(run));
+        }
+        catch (...) {
+            for (size_t i = 0; i < chunks; ++i) {
+                run(i);
+            }
+            return;
+        }
+        const bool posted = Post(job);
+        while (job->RunNext()) {
+        }
+        if (posted) {
+            Remove(job.get());
+        }
+        job->Wait();
     }
 
 private:
-    RawMemory<T> data_;
-    size_t size_ = 0;
+    ThreadPool() noexcept {
+        const size_t count = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+        if (count == 0) {
+            return;
+        }
+        workers_.reset(new (std::nothrow) std::thread[count]);
+        if (!workers_) {
+            return;
+        }
+        for (; worker_count_ < count; ++worker_count_) {
+            try {
+                workers_[worker_count_] = std::thread(&ThreadPool::Work, this);
+            }
+            catch (...) {
+                break;
+            }
+        }
+    }
 
-    template<typename... Args>
-    iterator Realocate(const_iterator pos, Args&&... args) {
-        size_t idx = std::distance(cbegin(), pos);
-        RawMemory<T> new_data(size_ == 0 ? 1 : size_ * 2);
-        auto result = std::construct_at(&new_data[idx], std::forward<Args>(args)...);
-        auto ptr = iterator(pos);
+    ~ThreadPool() {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (size_t i = 0; i < worker_count_; ++i) {
+            workers_[i].join();
+        }
+    }
+
+    bool Post(const std::shared_ptr<ChunkJob>& job) noexcept {
+        if (worker_count_ == 0) {
+            return false;
+        }
         try {
-            if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-                std::uninitialized_move(begin(), ptr, new_data.GetAddress());
-                std::uninitialized_move(ptr, end(), new_data.GetAddress() + idx + 1);
+            std::lock_guard lock(mutex_);
+            jobs_.push_back(job);
+        }
+        catch (...) {
+            return false;
+        }
+        wake_.notify_all();
+        return true;
+    }
+
+    // Убирает задание, у которого не осталось свободных кусков, из очереди
+    void Remove(const ChunkJob* job) noexcept {
+        std::lock_guard lock(mutex_);
+        const auto it = std::find_if(jobs_.begin(), jobs_.end(), [job](const std::shared_ptr<ChunkJob>& queued) {
+            return queued.get() == job;
+        });
+        if (it != jobs_.end()) {
+            jobs_.erase(it);
+        }
+    }
+
+    // Поток пула берёт первое задание в очереди и выполняет его куски, пока они не кончатся.
+    // Задание живёт, пока на него ссылается хотя бы один поток
+    void Work() noexcept {
+        while (true) {
+            std::shared_ptr<ChunkJob> job;
+            {
+                std::unique_lock lock(mutex_);
+                wake_.wait(lock, [this] {
+                    return stop_ || !jobs_.empty();
+                });
+                if (stop_) {
+                    return;
+                }
+                job = jobs_.front();
             }
-            else {
-                std::uninitialized_copy(begin(), ptr, new_data.GetAddress());
-                std::uninitialized_copy(ptr, end(), new_data.GetAddress() + idx + 1);
+            while (job->RunNext()) {
             }
+            Remove(job.get());
+        }
+    }
+
+    std::unique_ptr<std::thread[]> workers_;
+    size_t worker_count_ = 0;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<std::shared_ptr<ChunkJob>> jobs_;
+    bool stop_ = false;
+};
+
+// Вызывает op(first, last) для кусков диапазона [0, n) в потоках ThreadPool, по куску на поток.
+// Кусок, на котором op бросил исключение, op откатывает сам, для остальных вызывается
+// undo(first, last), после чего первое исключение пробрасывается
+template <typename Op, typename Undo>
+void ForEachChunk(size_t n, Op op, Undo undo) {
+    ThreadPool& pool = ThreadPool::Instance();
+    const size_t chunks = std::clamp<size_t>(n / kMinChunkSize, 1, pool.Concurrency());
+    std::unique_ptr<std::exception_ptr[]> errors(chunks > 1 ? new (std::nothrow) std::exception_ptr[chunks] : nullptr);
+    if (!errors) {
+        op(size_t{0}, n);
+        return;
+    }
+    auto run = [&](size_t index) noexcept {
+        try {
+            op(ChunkBegin(n, chunks, index), ChunkBegin(n, chunks, index + 1));
         }
         catch (...) {
-            std::destroy_at(result);
-            throw;
+            errors[index] = std::current_exception();
         }
-        std::destroy(begin(), end());
-        data_.Swap(new_data);
-        ++size_;
-        return result;
+    };
+    pool.ForEach(chunks, run);
+    std::exception_ptr error;
+    for (size_t i = 0; i < chunks && !error; ++i) {
+        error = errors[i];
+    }
+    if (error) {
+        for (size_t i = 0; i < chunks; ++i) {
+            if (!errors[i]) {
+                undo(ChunkBegin(n, chunks, i), ChunkBegin(n, chunks, i + 1));
+            }
+        }
+        std::rethrow_exception(error);
     }
+}
+
+}  // namespace vector_parallel
 
-    void AllocateOnCapacity(const Vector& rhs) {
-        std::copy(rhs.begin(), rhs.begin() + std::min(size_, rhs.size_), begin());
-        if (size_ > rhs.size_) {
-            std::destroy(begin() + rhs.size_, end());
+// Аналоги std::uninitialized_*, пригодные для вычисления на этапе компиляции: алгоритмы
+// стандартной библиотеки строят элементы через placement new, а в constexpr-контексте
+// допустим только std::construct_at. Вне него вызываются сами алгоритмы std
+namespace vector_uninitialized {
+
+// Строит элементы в [dest, dest + n) выражением make(dest + i). Если очередное построение
+// бросит исключение, уже построенные элементы разрушаются
+template <typename T, typename Make>
+constexpr void ConstructN(T* dest, size_t n, Make make) {
+    size_t i = 0;
+    try {
+        for (; i < n; ++i) {
+            make(dest + i);
         }
-        else {
-            std::uninitialized_copy(rhs.begin() + size_, rhs.end(), end());
+    }
+    catch (...) {
+        std::destroy_n(dest, i);
+        throw;
+    }
+}
+
+template <typename T>
+constexpr void ValueConstructN(T* dest, size_t n) {
+    if (std::is_constant_evaluated()) {
+        ConstructN(dest, n, [](T* p) { std::construct_at(p); });
+    }
+    else {
+        std::uninitialized_value_construct_n(dest, n);
+    }
+}
+
+// При вычислении на этапе компиляции неинициализированные значения недопустимы,
+// поэтому там элементы инициализируются значением
+template <typename T>
+constexpr void DefaultConstructN(T* dest, size_t n) {
+    if (std::is_constant_evaluated()) {
+        ValueConstructN(dest, n);
+    }
+    else {
+        std::uninitialized_default_construct_n(dest, n);
+    }
+}
+
+template <typename InputIt, typename T>
+constexpr void CopyN(InputIt first, size_t n, T* dest) {
+    if (std::is_constant_evaluated()) {
+        ConstructN(dest, n, [&first](T* p) { std::construct_at(p, *first++); });
+    }
+    else {
+        std::uninitialized_copy_n(first, n, dest);
+    }
+}
+
+template <typename T>
+constexpr void MoveN(T* first, size_t n, T* dest) {
+    if (std::is_constant_evaluated()) {
+        ConstructN(dest, n, [&first](T* p) { std::construct_at(p, std::move(*first++)); });
+    }
+    else {
+        std::uninitialized_move_n(first, n, dest);
+    }
+}
+
+// Элементы типа T переносятся перемещением: побайтово, если тип тривиально перемещаем,
+// иначе конструктором перемещения, если он не бросает исключений или копирование недоступно.
+// Иначе элементы копируются, чтобы при исключении исходные остались нетронутыми
+template <typename T>
+inline constexpr bool kRelocatesByMove =
+    is_trivially_relocatable_v<T> || std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>;
+
+// Переносит n элементов из first в неинициализированную память dest так, как описано
+// у kRelocatesByMove. Тривиально перемещаемые типы копируются одним memcpy.
+// Исходные элементы после переноса разрушаются через DestroyRelocated
+template <typename T>
+constexpr void RelocateN(T* first, size_t n, T* dest) {
+    // constexpr оператор if будет вычислен во время компиляции
+    if constexpr (is_trivially_relocatable_v<T>) {
+        // На этапе компиляции побайтовое копирование объектов недоступно
+        if (std::is_constant_evaluated()) {
+            MoveN(first, n, dest);
+        }
+        else if (n != 0) {
+            std::memcpy(static_cast<void*>(dest), static_cast<const void*>(first), n * sizeof(T));
+        }
+    }
+    else if constexpr (kRelocatesByMove<T>) {
+        MoveN(first, n, dest);
+    }
+    else {
+        CopyN(first, n, dest);
+    }
+}
+
+// Разрушает n элементов, перенесённых из first при помощи RelocateN
+template <typename T>
+constexpr void DestroyRelocated(T* first, size_t n) noexcept {
+    if (!is_trivially_relocatable_v<T> || std::is_constant_evaluated()) {
+        std::destroy_n(first, n);
+    }
+}
+
+}  // namespace vector_uninitialized
+
+// При InlineCapacity > 0 до InlineCapacity элементов хранятся внутри самого вектора (см. SmallVector).
+// Stats получает события о выделениях памяти и переносах элементов (см. NoVectorStats)
+template <typename T, typename Alloc = std::allocator<T>, typename GrowthPolicy = DoublingGrowth,
+          size_t InlineCapacity = 0, typename Stats = NoVectorStats>
+class Vector {
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using Memory = RawMemory<T, Alloc, InlineCapacity, Stats>;
+
+#if ADVANCED_VECTOR_CHECK_LEVEL >= 2
+    template <bool IsConst>
+    class CheckedIterator;
+#endif
+
+public:
+    using value_type = T;
+#if ADVANCED_VECTOR_CHECK_LEVEL >= 2
+    using iterator = CheckedIterator<false>;
+    using const_iterator = CheckedIterator<true>;
+#else
+    using iterator = T*;
+    using const_iterator = const T*;
+#endif
+    using allocator_type = Alloc;
+
+    Vector() = default;
+
+    constexpr explicit Vector(const Alloc& alloc) noexcept
+        : data_(alloc) {
+    }
+
+    constexpr explicit Vector(size_t size, const Alloc& alloc = Alloc())
+        : data_(size, alloc)
+        , size_(size) {
+        vector_uninitialized::ValueConstructN(Data(), size);
+        PoisonCapacity();
+    }
+
+    constexpr Vector(size_t size, DefaultInitTag, const Alloc& alloc = Alloc())
+        : data_(size, alloc)
+        , size_(size) {
+        vector_uninitialized::DefaultConstructN(Data(), size);
+        PoisonCapacity();
+    }
+
+    constexpr ~Vector() {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            std::destroy_n(Data(), size_);
         }
-        size_ = rhs.size_;
+        UnpoisonCapacity();
+        // Вектор без элементов и без своего буфера в куче (в том числе оставшийся после
+        // перемещения или обмена) ничего не хранил, и в статистику размеров не попадает
+        if (size_ > 0 || (Data() != nullptr && !data_.IsInline())) {
+            Stats::OnDestroy(size_);
+        }
+    }
+
+    constexpr Vector(const Vector& other)
+        : Vector(other, AllocTraits::select_on_container_copy_construction(other.GetAllocator())) {
+    }
+
+    constexpr Vector(const Vector& other, const Alloc& alloc)
+        : data_(other.size_, alloc)
+        , size_(other.size_) {
+        vector_uninitialized::CopyN(other.Data(), size_, Data());
+        PoisonCapacity();
+    }
+
+    // Копирует other, распределяя копирование элементов по потокам. Если копирование какого-либо
+    // элемента бросает исключение, все скопированные элементы разрушаются
+    Vector(const Vector& other, ParallelTag)
+        : data_(other.size_, AllocTraits::select_on_container_copy_construction(other.GetAllocator())) {
+        const T* src = other.Data();
+        T* dest = Data();
+        vector_parallel::ForEachChunk(
+            other.size_,
+            [src, dest](size_t first, size_t last) {
+                std::uninitialized_copy(src + first, src + last, dest + first);
+            },
+            [dest](size_t first, size_t last) noexcept {
+                std::destroy(dest + first, dest + last);
+            });
+        size_ = other.size_;
+        PoisonCapacity();
     }
-};
\ No newline at end of file
+
+    constexpr Vector& operator=(const Vector& rhs) {
+        if (this != &rhs) {
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::value) {
+                if (GetAllocator() != rhs.GetAllocator()) {
+                    // Память, выделенную своим аллокатором, нельзя переиспользовать с чужим
+                    std::destroy_n(Data(), size_);
+                    size_ = 0;
+                    UnpoisonCapacity();
+                    data_.Reset(rhs.GetAllocator());
+                    InvalidateIterators();
+                }
+            }
+            if (rhs.size_ > data_.Capacity()) {
+                Vector rhs_copy(rhs, GetAllocator());
+                StealFrom(rhs_copy);
+            }
+            else {
+                AllocateOnCapacity(rhs.Data(), rhs.size_);
+            }
+        }
+        return *this;
+    }
+
+    constexpr Vector(Vector&& other) noexcept(kNothrowRelocateInline)
+        : data_(std::move(other.data_)) {
+        if (data_.IsInline()) {
+            // Встроенный буфер не переходит к новому владельцу, поэтому элементы переносятся
+            RelocateN(other.Data(), other.size_, Data());
+            vector_uninitialized::DestroyRelocated(other.Data(), other.size_);
+        }
+        size_ = std::exchange(other.size_, 0);
+        other.InvalidateIterators();
+    }
+
+    constexpr Vector& operator=(Vector&& rhs) noexcept((AllocTraits::propagate_on_container_move_assignment::value
+                                              || AllocTraits::is_always_equal::value)
+                                             && kNothrowRelocateInline) {
+        if (this != &rhs) {
+            if constexpr (AllocTraits::propagate_on_container_move_assignment::value
+                          || AllocTraits::is_always_equal::value) {
+                StealFrom(rhs);
+            }
+            else if (GetAllocator() == rhs.GetAllocator()) {
+                StealFrom(rhs);
+            }
+            else if (rhs.size_ > data_.Capacity()) {
+                // Буфер rhs забрать нельзя: переносим элементы поштучно в память своего аллокатора
+                Vector rhs_copy(GetAllocator());
+                rhs_copy.Reserve(rhs.size_);
+                {
+                    SpareAccess access(rhs_copy, rhs.size_);
+                    vector_uninitialized::MoveN(rhs.Data(), rhs.size_, rhs_copy.Data());
+                    rhs_copy.size_ = rhs.size_;
+                }
+                StealFrom(rhs_copy);
+            }
+            else {
+                AllocateOnCapacity(std::make_move_iterator(rhs.Data()), rhs.size_);
+            }
+        }
+        return *this;
+    }
+
+    // Обмен разрешён, только если аллокаторы распространяются при обмене или равны
+    constexpr void Swap(Vector& other) noexcept(kNothrowRelocateInline) {
+        ADVANCED_VECTOR_CHECK(AllocTraits::propagate_on_container_swap::value || GetAllocator() == other.GetAllocator());
+        if (data_.IsInline() || other.data_.IsInline()) {
+            Vector tmp(std::move(other));
+            other.StealFrom(*this);
+            StealFrom(tmp);
+            return;
+        }
+        data_.Swap(other.data_);
+        std::swap(size_, other.size_);
+        InvalidateIterators();
+        other.InvalidateIterators();
+    }
+
+    constexpr Alloc GetAllocator() const noexcept {
+        return data_.GetAllocator();
+    }
+
+    constexpr void Reserve(size_t new_capacity) {
+        if (new_capacity <= data_.Capacity() || TryExpand(new_capacity)) {
+            return;
+        }
+        ReportRealocate();
+        CapacityAccess access(*this);
+        if constexpr (kCanReallocate) {
+            data_.Reallocate(new_capacity);
+            InvalidateIterators();
+            return;
+        }
+        Memory new_data(new_capacity, data_.GetAllocator());
+        RelocateN(Data(), size_, new_data.GetAddress());
+        vector_uninitialized::DestroyRelocated(Data(), size_);
+        data_.Swap(new_data);
+        InvalidateIterators();
+    }
+
+    // Reserve, переносящий элементы в новый буфер в нескольких потоках
+    void Reserve(size_t new_capacity, ParallelTag) {
+        if constexpr (kCanReallocate) {
+            // realloc переносит блок целиком, делить его на куски незачем
+            Reserve(new_capacity);
+        }
+        else {
+            if (new_capacity <= data_.Capacity() || TryExpand(new_capacity)) {
+                return;
+            }
+            ReportRealocate();
+            CapacityAccess access(*this);
+            Memory new_data(new_capacity, data_.GetAllocator());
+            ParallelRelocateN(Data(), size_, new_data.GetAddress());
+            ParallelDestroyRelocated(Data(), size_);
+            data_.Swap(new_data);
+            InvalidateIterators();
+        }
+    }
+
+    constexpr size_t Size() const noexcept {
+        return size_;
+    }
+
+    constexpr size_t Capacity() const noexcept {
+        return data_.Capacity();
+    }
+
+    constexpr const T& operator[](size_t index) const noexcept {
+        return const_cast<Vector&>(*this)[index];
+    }
+
+    constexpr T& operator[](size_t index) noexcept {
+        ADVANCED_VECTOR_CHECK(index < size_);
+        return data_[index];
+    }
+
+    // Указатель на первый элемент (nullptr у вектора без буфера). В отладочном режиме,
+    // в отличие от итераторов, ничего не проверяет
+    constexpr T* Data() noexcept {
+        return data_.GetAddress();
+    }
+
+    constexpr const T* Data() const noexcept {
+        return data_.GetAddress();
+    }
+
+    constexpr void Resize(size_t new_size) {
+        ResizeWith(new_size, [](T* first, size_t count) {
+            vector_uninitialized::ValueConstructN(first, count);
+        });
+    }
+
+    // Как Resize, но новые элементы инициализируются по умолчанию: буфер тривиальных
+    // типов не обнуляется перед тем, как его перезапишут
+    constexpr void ResizeDefaultInit(size_t new_size) {
+        ResizeWith(new_size, [](T* first, size_t count) {
+            vector_uninitialized::DefaultConstructN(first, count);
+        });
+    }
+
+    // Уменьшает вместимость до размера, возвращая лишнюю память аллокатору.
+    // У SmallVector элементы возвращаются во встроенный буфер, если помещаются в него
+    constexpr void ShrinkToFit() {
+        if (size_ < data_.Capacity() && !data_.IsInline()) {
+            ShrinkTo(size_);
+        }
+    }
+
+    // Уничтожает все элементы, сохраняя вместимость
+    constexpr void Clear() noexcept {
+        std::destroy_n(Data(), size_);
+        AnnotateShrink(std::exchange(size_, 0));
+    }
+
+    // Clear, разрушающий элементы в нескольких потоках
+    void Clear(ParallelTag) noexcept {
+        ParallelDestroyN(Data(), size_);
+        AnnotateShrink(std::exchange(size_, 0));
+    }
+
+    // Уничтожает все элементы и освобождает память
+    constexpr void ClearAndRelease() noexcept {
+        Clear();
+        UnpoisonCapacity();
+        data_ = Memory(data_.GetAllocator());
+        InvalidateIterators();
+    }
+
+    // Непрерывный кусок count элементов, начиная с offset (по умолчанию до конца), без копирования.
+    // Инвалидируется, как и итераторы
+    constexpr std::span<T> Subspan(size_t offset, size_t count = std::dynamic_extent) noexcept {
+        ADVANCED_VECTOR_CHECK(offset <= size_);
+        if (count == std::dynamic_extent) {
+            count = size_ - offset;
+        }
+        ADVANCED_VECTOR_CHECK(count <= size_ - offset);
+        return {Data() + offset, count};
+    }
+
+    constexpr std::span<const T> Subspan(size_t offset, size_t count = std::dynamic_extent) const noexcept {
+        return const_cast<Vector&>(*this).Subspan(offset, count);
+    }
+
+    // Отдаёт буфер с элементами вызывающему, который отвечает за их разрушение и освобождение
+    // памяти через GetAllocator(). Вектор становится пустым. Элементы из встроенного буфера
+    // сначала переносятся в кучу
+    [[nodiscard]] constexpr VectorBuffer<T> Release() noexcept(InlineCapacity == 0) {
+        if (data_.IsInline()) {
+            if (size_ == 0) {
+                return {nullptr, 0, 0};
+            }
+            Memory heap_data(data_.GetAllocator());
+            heap_data.AllocateOnHeap(size_);
+            RelocateN(Data(), size_, heap_data.GetAddress());
+            vector_uninitialized::DestroyRelocated(Data(), size_);
+            data_.Swap(heap_data);
+        }
+        // Вызывающий волен писать во всю вместимость буфера
+        UnpoisonCapacity();
+        VectorBuffer<T> buffer{Data(), size_, data_.Capacity()};
+        data_.Release();
+        size_ = 0;
+        InvalidateIterators();
+        return buffer;
+    }
+
+    // Уничтожает свои элементы и забирает буфер data, в котором построено size элементов.
+    // Блок на capacity элементов должен быть выделен аллокатором, равным GetAllocator()
+    constexpr void Adopt(T* data, size_t size, size_t capacity) noexcept(kNothrowRelocateInline) {
+        ADVANCED_VECTOR_CHECK(size <= capacity && (data != nullptr || capacity == 0));
+        Clear();
+        UnpoisonCapacity();
+        InvalidateIterators();
+        if (InlineCapacity > 0 && data != nullptr && capacity <= InlineCapacity) {
+            // Блок в куче не больше встроенного буфера, а рост из него рассчитан только на кучу.
+            // Элементы переносятся во встроенный буфер, блок освобождается при разрушении adopted
+            Memory adopted(data_.GetAllocator());
+            adopted.Adopt(data, capacity);
+            data_.Adopt(nullptr, 0);
+            if constexpr (kNothrowRelocateInline) {
+                RelocateN(data, size, Data());
+            }
+            else {
+                try {
+                    RelocateN(data, size, Data());
+                }
+                catch (...) {
+                    std::destroy_n(data, size);
+                    throw;
+                }
+            }
+            vector_uninitialized::DestroyRelocated(data, size);
+        }
+        else {
+            data_.Adopt(data, capacity);
+        }
+        size_ = size;
+        PoisonCapacity();
+    }
+
+    constexpr void Adopt(VectorBuffer<T> buffer) noexcept(kNothrowRelocateInline) {
+        Adopt(buffer.data, buffer.size, buffer.capacity);
+    }
+
+    // Аналог basic_string::resize_and_overwrite: устанавливает размер count (новые элементы
+    // инициализируются по умолчанию) и вызывает op(data, count). op заполняет буфер
+    // и возвращает итоговый размер, не больший count
+    template <typename Operation>
+    constexpr void ResizeAndOverwrite(size_t count, Operation op) {
+        ResizeDefaultInit(count);
+        const size_t new_size = std::move(op)(Data(), count);
+        ADVANCED_VECTOR_CHECK(new_size <= count);
+        std::destroy_n(Data() + new_size, count - new_size);
+        size_ = new_size;
+        AnnotateShrink(count);
+    }
+
+    constexpr void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+
+    constexpr void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    constexpr void PopBack() noexcept {
+        ADVANCED_VECTOR_CHECK(size_ != 0);
+        --size_;
+        std::destroy_at(Data() + size_);
+        AnnotateShrink(size_ + 1);
+        MaybeShrink();
+    }
+
+    template<typename... Args>
+    constexpr T& EmplaceBack(Args&&... args) {
+        return *EmplaceImpl(Data() + size_, MayAlias(args...), std::forward<Args>(args)...);
+    }
+
+    template<typename... Args>
+    constexpr iterator Emplace(const_iterator pos, Args&&... args) {
+        return MakeIterator(EmplaceImpl(ToPointer(pos), MayAlias(args...), std::forward<Args>(args)...));
+    }
+
+    // Как Emplace, но вызывающий гарантирует, что аргументы не ссылаются на элементы вектора.
+    // Тогда элемент создаётся сразу на своём месте, без временного объекта
+    template<typename... Args>
+    constexpr iterator EmplaceAtUnchecked(const_iterator pos, Args&&... args) {
+        return MakeIterator(EmplaceImpl(ToPointer(pos), false, std::forward<Args>(args)...));
+    }
+
+    constexpr iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+
+    constexpr iterator Insert(const_iterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    // Вставляет count копий value перед pos, выделяя память не более одного раза
+    constexpr iterator Insert(const_iterator pos, size_t count, const T& value) {
+        if (IsInside(std::addressof(value))) {
+            // value — элемент этого вектора и может сдвинуться при вставке
+            T value_copy(value);
+            return MakeIterator(InsertN(ToPointer(pos), RepeatIterator(&value_copy), count));
+        }
+        return MakeIterator(InsertN(ToPointer(pos), RepeatIterator(&value), count));
+    }
+
+    // Вставляет элементы диапазона [first, last) перед pos. Итераторы не должны указывать
+    // на элементы этого вектора. Для однопроходных итераторов элементы добавляются в конец
+    // и затем переставляются на место одним std::rotate
+    template <std::input_iterator InputIt>
+    constexpr iterator Insert(const_iterator pos, InputIt first, InputIt last) {
+        if constexpr (std::forward_iterator<InputIt>) {
+            return MakeIterator(InsertN(ToPointer(pos), first, static_cast<size_t>(std::distance(first, last))));
+        }
+        else {
+            const T* ptr = ToPointer(pos);
+            ADVANCED_VECTOR_CHECK(ptr >= Data() && ptr <= Data() + size_);
+            const size_t idx = ptr - Data();
+            const size_t old_size = size_;
+            for (; first != last; ++first) {
+                EmplaceBack(*first);
+            }
+            std::rotate(Data() + idx, Data() + old_size, Data() + size_);
+            return MakeIterator(Data() + idx);
+        }
+    }
+
+    constexpr iterator Insert(const_iterator pos, std::initializer_list<T> values) {
+        return MakeIterator(InsertN(ToPointer(pos), values.begin(), values.size()));
+    }
+
+    // Добавляет в конец все элементы диапазона. Если размер диапазона известен,
+    // память выделяется не более одного раза
+    template <std::ranges::input_range Range>
+    constexpr void Append(Range&& range) {
+        if constexpr (std::ranges::sized_range<Range> && std::ranges::forward_range<Range>) {
+            const size_t count = static_cast<size_t>(std::ranges::size(range));
+            if (count > data_.Capacity() - size_) {
+                InsertN(Data() + size_, std::ranges::begin(range), count);
+                return;
+            }
+            // Диапазон помещается в свободную ёмкость: сдвигать и перевыделять нечего
+            SpareAccess access(*this, count);
+            vector_uninitialized::CopyN(std::ranges::begin(range), count, Data() + size_);
+            size_ += count;
+        }
+        else {
+            for (auto&& value : range) {
+                EmplaceBack(std::forward<decltype(value)>(value));
+            }
+        }
+    }
+
+    constexpr iterator Erase(const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        T* ptr = ToPointer(pos);
+        ADVANCED_VECTOR_CHECK(ptr >= Data() && ptr < Data() + size_);
+        const size_t idx = ptr - Data();
+        if (size_) {
+            std::move(ptr + 1, Data() + size_, ptr);
+            PopBack();
+        }
+        return MakeIterator(Data() + idx);
+    }
+
+    // Удаляет элементы [first, last), сдвигая хвост один раз
+    constexpr iterator Erase(const_iterator first, const_iterator last) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        T* first_ptr = ToPointer(first);
+        T* last_ptr = ToPointer(last);
+        ADVANCED_VECTOR_CHECK(first_ptr >= Data() && first_ptr <= last_ptr && last_ptr <= Data() + size_);
+        const size_t idx = first_ptr - Data();
+        if (first_ptr != last_ptr) {
+            T* new_end = std::move(last_ptr, Data() + size_, first_ptr);
+            std::destroy(new_end, Data() + size_);
+            AnnotateShrink(std::exchange(size_, new_end - Data()));
+            MaybeShrink();
+        }
+        return MakeIterator(Data() + idx);
+    }
+
+    // Удаляет все элементы, для которых pred возвращает true, за один проход
+    // с сохранением порядка остальных. Возвращает количество удалённых элементов
+    template <typename Predicate>
+    constexpr size_t EraseIf(Predicate pred) {
+        T* new_end = std::remove_if(Data(), Data() + size_, std::ref(pred));
+        const size_t removed = Data() + size_ - new_end;
+        std::destroy(new_end, Data() + size_);
+        size_ -= removed;
+        AnnotateShrink(size_ + removed);
+        MaybeShrink();
+        return removed;
+    }
+
+    // Удаляет элемент за O(1), перемещая на его место последний элемент.
+    // Порядок элементов не сохраняется
+    constexpr iterator UnorderedErase(const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        T* ptr = ToPointer(pos);
+        ADVANCED_VECTOR_CHECK(ptr >= Data() && ptr < Data() + size_);
+        const size_t idx = ptr - Data();
+        if (idx != size_ - 1) {
+            *ptr = std::move(data_[size_ - 1]);
+        }
+        PopBack();
+        return MakeIterator(Data() + idx);
+    }
+
+    constexpr iterator begin() noexcept {
+        return MakeIterator(Data());
+    }
+
+    constexpr iterator end() noexcept {
+        return MakeIterator(Data() + size_);
+    }
+
+    constexpr const_iterator begin() const noexcept {
+        return MakeIterator(Data());
+    }
+
+    constexpr const_iterator end() const noexcept {
+        return MakeIterator(Data() + size_);
+    }
+
+    constexpr const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    constexpr const_iterator cend() const noexcept {
+        return end();
+    }
+
+    // Целые числа, перечисления и указатели сравниваются одним memcmp, кроме вычисления
+    // на этапе компиляции. Остальные типы, даже без padding-байтов, сравниваются своим
+    // operator==: он не обязан сравнивать все байты объекта
+    friend constexpr bool operator==(const Vector& lhs, const Vector& rhs) {
+        if (lhs.size_ != rhs.size_) {
+            return false;
+        }
+        if constexpr (std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>) {
+            if (!std::is_constant_evaluated()) {
+                return lhs.size_ == 0 || std::memcmp(lhs.Data(), rhs.Data(), lhs.size_ * sizeof(T)) == 0;
+            }
+        }
+        return std::equal(lhs.Data(), lhs.Data() + lhs.size_, rhs.Data());
+    }
+
+private:
+    // Буфер можно перевыделять через realloc-подобный метод аллокатора
+    static constexpr bool kCanReallocate = is_trivially_relocatable_v<T> && AllocatorWithReallocate<Alloc>;
+    // Политика роста требует освобождать память при удалении элементов (см. ShrinkingGrowth)
+    static constexpr bool kShrinkOnErase = requires {
+        requires GrowthPolicy::kShrinkOnErase;
+    };
+    // Перенос элементов из встроенного буфера при перемещении не бросает исключений
+    static constexpr bool kNothrowRelocateInline = InlineCapacity == 0 || is_trivially_relocatable_v<T>
+                                                   || std::is_nothrow_move_constructible_v<T>;
+
+    Memory data_;
+    size_t size_ = 0;
+#if ADVANCED_VECTOR_CHECK_LEVEL >= 2
+    // Поколение буфера: растёт при каждой смене буфера, после которой итераторы недействительны
+    size_t generation_ = 0;
+#endif
+
+#if ADVANCED_VECTOR_CHECK_LEVEL >= 2
+    constexpr iterator MakeIterator(T* ptr) noexcept {
+        return {this, ptr};
+    }
+
+    constexpr const_iterator MakeIterator(const T* ptr) const noexcept {
+        return {this, ptr};
+    }
+
+    // Адрес элемента, на который указывает pos. Итератор должен быть получен от этого вектора
+    // после последней смены буфера
+    constexpr T* ToPointer(const_iterator pos) const noexcept {
+        ADVANCED_VECTOR_CHECK(pos.owner_ == this && pos.generation_ == generation_);
+        return const_cast<T*>(pos.ptr_);
+    }
+
+    constexpr void InvalidateIterators() noexcept {
+        ++generation_;
+    }
+#else
+    static constexpr iterator MakeIterator(T* ptr) noexcept {
+        return ptr;
+    }
+
+    static constexpr const_iterator MakeIterator(const T* ptr) noexcept {
+        return ptr;
+    }
+
+    static constexpr T* ToPointer(const_iterator pos) noexcept {
+        return const_cast<T*>(pos);
+    }
+
+    static constexpr void InvalidateIterators() noexcept {
+    }
+#endif
+
+    // Сдвигает границу доступной для ASan части буфера с old_mid на new_mid элементов от его
+    // начала. Встроенный буфер переезжает вместе с объектом и не размечается. libasan умеет
+    // размечать только участок из целых 8-байтовых гранул, поэтому буфер, не выровненный
+    // по 8 байт, пропускается, а неполная гранула в конце остаётся открытой: иначе разметка
+    // задела бы соседний блок арены или часть, которая добавится при расширении на месте
+    constexpr void AnnotateContainer([[maybe_unused]] size_t old_mid, [[maybe_unused]] size_t new_mid) const noexcept {
+#ifdef ADVANCED_VECTOR_ANNOTATE_CONTAINER
+        if (std::is_constant_evaluated()) {
+            return;
+        }
+        constexpr size_t kGranule = 8;
+        const auto* first = reinterpret_cast<const unsigned char*>(data_.GetAddress());
+        if (first == nullptr || data_.IsInline() || reinterpret_cast<uintptr_t>(first) % kGranule != 0) {
+            return;
+        }
+        const auto* last = first + data_.Capacity() * sizeof(T) / kGranule * kGranule;
+        if (last != first) {
+            __sanitizer_annotate_contiguous_container(first, last, std::min(first + old_mid * sizeof(T), last),
+                                                      std::min(first + new_mid * sizeof(T), last));
+        }
+#endif
+    }
+
+    // Закрывает для ASan незанятую часть буфера [Size(), Capacity()), которая сейчас открыта:
+    // буфер только что выделен или его открыл UnpoisonCapacity
+    constexpr void PoisonCapacity() const noexcept {
+        AnnotateContainer(data_.Capacity(), size_);
+    }
+
+    // Открывает для ASan весь буфер перед записью за Size() или перед освобождением памяти
+    constexpr void UnpoisonCapacity() const noexcept {
+        AnnotateContainer(size_, data_.Capacity());
+    }
+
+    // Закрывает ячейки элементов [Size(), old_size), разрушенных при уменьшении размера
+    constexpr void AnnotateShrink(size_t old_size) const noexcept {
+        AnnotateContainer(old_size, size_);
+    }
+
+    // Открывает весь буфер на время смены буфера. При выходе из области,
+    // в том числе по исключению, закрывает незанятую часть того буфера, который окажется у вектора.
+    // Объявляется раньше временных RawMemory, чтобы старый буфер освобождался открытым
+    class CapacityAccess {
+    public:
+        constexpr explicit CapacityAccess(const Vector& vector) noexcept
+            : vector_(vector) {
+            vector_.UnpoisonCapacity();
+        }
+
+        CapacityAccess(const CapacityAccess&) = delete;
+        CapacityAccess& operator=(const CapacityAccess&) = delete;
+
+        constexpr ~CapacityAccess() {
+            vector_.PoisonCapacity();
+        }
+
+    private:
+        const Vector& vector_;
+    };
+
+    // Открывает для ASan только ячейки [Size(), Size() + count), куда пишутся новые элементы,
+    // без смены буфера. При выходе из области закрывает то, что осталось за Size(), в том числе
+    // при исключении или если размер в итоге уменьшился. В отличие от CapacityAccess стоит
+    // O(count), а не O(Capacity()), поэтому добавление в конец остаётся амортизированно O(1)
+    class SpareAccess {
+    public:
+        constexpr SpareAccess(const Vector& vector, size_t count) noexcept
+            : vector_(vector)
+            , open_end_(vector.size_ + count) {
+            vector_.AnnotateContainer(vector_.size_, open_end_);
+        }
+
+        SpareAccess(const SpareAccess&) = delete;
+        SpareAccess& operator=(const SpareAccess&) = delete;
+
+        constexpr ~SpareAccess() {
+            vector_.AnnotateContainer(open_end_, vector_.size_);
+        }
+
+    private:
+        const Vector& vector_;
+        size_t open_end_;
+    };
+
+    // Пытается расширить буфер на месте. Добавленная часть сразу закрывается для ASan
+    constexpr bool TryExpand(size_t new_capacity) noexcept {
+        if constexpr (AllocatorWithExpand<Alloc>) {
+            const size_t old_capacity = data_.Capacity();
+            UnpoisonCapacity();
+            const bool expanded = data_.TryExpand(new_capacity);
+            if (expanded) {
+                // Перед тем как закрыть хвост, открываем и добавленную часть буфера
+                AnnotateContainer(old_capacity, new_capacity);
+            }
+            PoisonCapacity();
+            return expanded;
+        }
+        else {
+            return false;
+        }
+    }
+
+    // Сообщает Stats о переносе элементов в новый буфер. Первое выделение памяти пустому
+    // вектору переносом не считается
+    constexpr void ReportRealocate() const noexcept {
+        if (size_ > 0) {
+            Stats::OnRealocate();
+        }
+    }
+
+    // Переносит элементы в буфер вместимостью new_capacity (size_ <= new_capacity < Capacity())
+    constexpr void ShrinkTo(size_t new_capacity) {
+        CapacityAccess access(*this);
+        if (new_capacity == 0) {
+            // Элементов нет: буфер просто освобождается
+            Memory old_data(std::move(data_));
+            InvalidateIterators();
+            return;
+        }
+        if (new_capacity <= InlineCapacity) {
+            // Элементы возвращаются во встроенный буфер, который освобождается при перемещении data_
+            Memory old_data(std::move(data_));
+            try {
+                RelocateN(old_data.GetAddress(), size_, Data());
+            }
+            catch (...) {
+                data_ = std::move(old_data);
+                throw;
+            }
+            vector_uninitialized::DestroyRelocated(old_data.GetAddress(), size_);
+            InvalidateIterators();
+            return;
+        }
+        if constexpr (kCanReallocate) {
+            data_.Reallocate(new_capacity);
+            InvalidateIterators();
+            return;
+        }
+        Memory new_data(new_capacity, data_.GetAllocator());
+        if (new_data.Capacity() >= data_.Capacity()) {
+            return;
+        }
+        RelocateN(Data(), size_, new_data.GetAddress());
+        vector_uninitialized::DestroyRelocated(Data(), size_);
+        data_.Swap(new_data);
+        InvalidateIterators();
+    }
+
+    // При политике роста с kShrinkOnErase вдвое уменьшает вместимость, как только элементов
+    // становится меньше четверти. Запас вдвое не даёт перевыделять память на каждой вставке
+    // после удаления. Ошибки выделения памяти игнорируются: вектор остаётся прежним
+    constexpr void MaybeShrink() noexcept {
+        if constexpr (kShrinkOnErase) {
+            if (size_ < data_.Capacity() / 4 && !data_.IsInline()) {
+                try {
+                    ShrinkTo(size_ * 2);
+                }
+                catch (...) {
+                }
+            }
+        }
+    }
+
+    // Изменяет размер, создавая недостающие элементы функцией construct_n(first, count)
+    template <typename ConstructN>
+    constexpr void ResizeWith(size_t new_size, ConstructN construct_n) {
+        if (new_size < size_) {
+            std::destroy_n(Data() + new_size, size_ - new_size);
+            AnnotateShrink(std::exchange(size_, new_size));
+        }
+        else if (new_size > size_) {
+            if (new_size > data_.Capacity()) {
+                Reserve(CalcCapacity(new_size));
+            }
+            SpareAccess access(*this, new_size - size_);
+            construct_n(Data() + size_, new_size - size_);
+            size_ = new_size;
+        }
+    }
+
+    // Вместимость, до которой нужно вырасти, чтобы поместилось required элементов
+    constexpr size_t CalcCapacity(size_t required) const noexcept {
+        return GrowthPolicy::NextCapacity(data_.Capacity(), required, sizeof(T));
+    }
+
+    // Аргумент — значение типа T, которое можно присвоить элементу
+    template <typename... Args>
+    static constexpr bool kIsValueArg = sizeof...(Args) == 1 && (std::is_same_v<std::remove_cvref_t<Args>, T> && ...);
+
+    // Объект по адресу p лежит внутри элементов вектора
+    constexpr bool IsInside(const void* p) const noexcept {
+        // Адреса разных объектов на этапе компиляции сравнивать нельзя: считаем, что
+        // объект может лежать внутри, и он будет скопирован заранее
+        if (std::is_constant_evaluated()) {
+            return true;
+        }
+        std::less<const void*> less;
+        return !less(p, Data()) && less(p, Data() + size_);
+    }
+
+    // Аргументы могут ссылаться на элементы вектора. Доказать обратное можно только для
+    // аргументов типа T и скалярных типов, расположенных вне буфера
+    template <typename... Args>
+    constexpr bool MayAlias(const Args&... args) const noexcept {
+        if constexpr (((std::is_same_v<Args, T> || std::is_arithmetic_v<Args> || std::is_enum_v<Args>) && ...)) {
+            return (IsInside(std::addressof(args)) || ...);
+        }
+        else {
+            return true;
+        }
+    }
+
+    template<typename... Args>
+    constexpr T* EmplaceImpl(T* pos, bool may_alias, Args&&... args) {
+        ADVANCED_VECTOR_CHECK(pos >= Data() && pos <= Data() + size_);
+        if (size_ == data_.Capacity() && !TryExpand(CalcCapacity(size_ + 1))) {
+            return Realocate(pos, may_alias, std::forward<Args>(args)...);
+        }
+        SpareAccess access(*this, 1);
+        T* old_end = Data() + size_;
+        if (pos == old_end) {
+            std::construct_at(pos, std::forward<Args>(args)...);
+        }
+        else if ((kIsValueArg<Args...> || std::is_nothrow_constructible_v<T, Args...>) && !may_alias) {
+            // Аргументы не изменятся при сдвиге, поэтому элемент присваивается
+            // или создаётся сразу на своём месте
+            std::construct_at(old_end, std::move(data_[size_ - 1]));
+            ++size_;
+            std::move_backward(pos, old_end - 1, old_end);
+            if constexpr (kIsValueArg<Args...>) {
+                ((*pos = std::forward<Args>(args)), ...);
+            }
+            else {
+                std::destroy_at(pos);
+                std::construct_at(pos, std::forward<Args>(args)...);
+            }
+            return pos;
+        }
+        else {
+            T tmp(std::forward<Args>(args)...);
+            std::construct_at(old_end, std::move(data_[size_ - 1]));
+            std::move_backward(pos, old_end - 1, old_end);
+            *pos = std::move(tmp);
+        }
+        ++size_;
+        return pos;
+    }
+
+    // При выделении нового буфера элемент сразу создаётся на своём месте: старый буфер
+    // остаётся нетронутым, пока из него переносятся элементы. При перевыделении через
+    // reallocate так можно делать, только если аргументы не ссылаются на элементы вектора
+    template<typename... Args>
+    constexpr T* Realocate(T* pos, bool may_alias, Args&&... args) {
+        const size_t idx = pos - Data();
+        ReportRealocate();
+        CapacityAccess access(*this);
+        if constexpr (kCanReallocate) {
+            if (!may_alias) {
+                data_.Reallocate(CalcCapacity(size_ + 1));
+                InvalidateIterators();
+                T* ptr = Data() + idx;
+                std::memmove(static_cast<void*>(ptr + 1), static_cast<const void*>(ptr), (size_ - idx) * sizeof(T));
+                try {
+                    std::construct_at(ptr, std::forward<Args>(args)...);
+                }
+                catch (...) {
+                    std::memmove(static_cast<void*>(ptr), static_cast<const void*>(ptr + 1), (size_ - idx) * sizeof(T));
+                    throw;
+                }
+                ++size_;
+                return ptr;
+            }
+            // Аргументы могут ссылаться на элементы вектора, поэтому новый элемент создаётся
+            // до перевыделения во временной памяти и потом переносится побайтово
+            alignas(T) unsigned char slot[sizeof(T)];
+            T* value = std::construct_at(reinterpret_cast<T*>(slot), std::forward<Args>(args)...);
+            try {
+                data_.Reallocate(CalcCapacity(size_ + 1));
+            }
+            catch (...) {
+                std::destroy_at(value);
+                throw;
+            }
+            InvalidateIterators();
+            T* ptr = Data() + idx;
+            std::memmove(static_cast<void*>(ptr + 1), static_cast<const void*>(ptr), (size_ - idx) * sizeof(T));
+            std::memcpy(static_cast<void*>(ptr), static_cast<const void*>(value), sizeof(T));
+            ++size_;
+            return ptr;
+        }
+        Memory new_data(CalcCapacity(size_ + 1), data_.GetAllocator());
+        auto result = std::construct_at(&new_data[idx], std::forward<Args>(args)...);
+        try {
+            RelocateN(Data(), idx, new_data.GetAddress());
+        }
+        catch (...) {
+            std::destroy_at(result);
+            throw;
+        }
+        try {
+            RelocateN(Data() + idx, size_ - idx, new_data.GetAddress() + idx + 1);
+        }
+        catch (...) {
+            std::destroy_n(new_data.GetAddress(), idx + 1);
+            throw;
+        }
+        vector_uninitialized::DestroyRelocated(Data(), size_);
+        data_.Swap(new_data);
+        InvalidateIterators();
+        ++size_;
+        return result;
+    }
+
+    // Однонаправленный итератор, бесконечно повторяющий одно и то же значение
+    class RepeatIterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        RepeatIterator() = default;
+
+        constexpr explicit RepeatIterator(const T* value) noexcept
+            : value_(value) {
+        }
+
+        constexpr reference operator*() const noexcept {
+            return *value_;
+        }
+
+        constexpr pointer operator->() const noexcept {
+            return value_;
+        }
+
+        constexpr RepeatIterator& operator++() noexcept {
+            return *this;
+        }
+
+        constexpr RepeatIterator operator++(int) noexcept {
+            return *this;
+        }
+
+        bool operator==(const RepeatIterator&) const = default;
+
+    private:
+        const T* value_ = nullptr;
+    };
+
+    // Вставляет count элементов, начиная с first, перед pos. Выделяет память не более одного
+    // раза и сдвигает хвост вектора тоже один раз
+    template <typename ForwardIt>
+    constexpr T* InsertN(T* pos, ForwardIt first, size_t count) {
+        ADVANCED_VECTOR_CHECK(pos >= Data() && pos <= Data() + size_);
+        if (count == 0) {
+            return pos;
+        }
+        const size_t idx = pos - Data();
+        if (size_ + count > data_.Capacity() && !TryExpand(CalcCapacity(size_ + count))) {
+            ReportRealocate();
+            CapacityAccess access(*this);
+            Memory new_data(CalcCapacity(size_ + count), data_.GetAllocator());
+            T* dest = new_data.GetAddress();
+            vector_uninitialized::CopyN(first, count, dest + idx);
+            try {
+                RelocateN(Data(), idx, dest);
+            }
+            catch (...) {
+                std::destroy_n(dest + idx, count);
+                throw;
+            }
+            try {
+                RelocateN(Data() + idx, size_ - idx, dest + idx + count);
+            }
+            catch (...) {
+                std::destroy_n(dest, idx + count);
+                throw;
+            }
+            vector_uninitialized::DestroyRelocated(Data(), size_);
+            data_.Swap(new_data);
+            InvalidateIterators();
+            size_ += count;
+            return Data() + idx;
+        }
+        SpareAccess access(*this, count);
+        T* ptr = pos;
+        T* old_end = Data() + size_;
+        const size_t tail = size_ - idx;
+        if (count < tail) {
+            // Последние count элементов переезжают в неинициализированную память,
+            // остальные сдвигаются присваиванием
+            vector_uninitialized::MoveN(old_end - count, count, old_end);
+            size_ += count;
+            std::move_backward(ptr, old_end - count, old_end);
+            std::copy_n(first, count, ptr);
+        }
+        else {
+            // Часть новых элементов сразу попадает в неинициализированную память за хвостом
+            ForwardIt mid = std::next(first, tail);
+            vector_uninitialized::CopyN(mid, count - tail, old_end);
+            try {
+                vector_uninitialized::MoveN(ptr, tail, ptr + count);
+            }
+            catch (...) {
+                std::destroy_n(old_end, count - tail);
+                throw;
+            }
+            size_ += count;
+            std::copy_n(first, tail, ptr);
+        }
+        return ptr;
+    }
+
+    // Переносит n элементов из first в неинициализированную память dest
+    // (см. vector_uninitialized::RelocateN) и сообщает Stats, перемещались они или копировались
+    static constexpr void RelocateN(T* first, size_t n, T* dest) {
+        vector_uninitialized::RelocateN(first, n, dest);
+        if constexpr (vector_uninitialized::kRelocatesByMove<T>) {
+            Stats::OnMove(n);
+        }
+        else {
+            Stats::OnCopy(n);
+        }
+    }
+
+    // Параллельный аналог RelocateN: куски переносятся в разных потоках. Если перенос куска
+    // бросает исключение, уже перенесённые в dest элементы разрушаются
+    static void ParallelRelocateN(T* first, size_t n, T* dest) {
+        vector_parallel::ForEachChunk(
+            n,
+            [first, dest](size_t from, size_t to) {
+                RelocateN(first + from, to - from, dest + from);
+            },
+            [dest](size_t from, size_t to) noexcept {
+                std::destroy(dest + from, dest + to);
+            });
+    }
+
+    static void ParallelDestroyRelocated(T* first, size_t n) noexcept {
+        if constexpr (!is_trivially_relocatable_v<T>) {
+            ParallelDestroyN(first, n);
+        }
+    }
+
+    static void ParallelDestroyN(T* first, size_t n) noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            vector_parallel::ForEachChunk(
+                n,
+                [first](size_t from, size_t to) noexcept {
+                    std::destroy(first + from, first + to);
+                },
+                [](size_t, size_t) noexcept {
+                });
+        }
+    }
+
+    // Присваивает count элементов, начиная с first, не выделяя память (count <= Capacity())
+    template <typename InputIt>
+    constexpr void AllocateOnCapacity(InputIt first, size_t count) {
+        SpareAccess access(*this, count > size_ ? count - size_ : 0);
+        std::copy_n(first, std::min(size_, count), Data());
+        if (size_ > count) {
+            std::destroy(Data() + count, Data() + size_);
+        }
+        else {
+            vector_uninitialized::CopyN(first + size_, count - size_, Data() + size_);
+        }
+        size_ = count;
+    }
+
+    // Уничтожает свои элементы и забирает буфер rhs. Элементы из встроенного буфера rhs переносятся
+    constexpr void StealFrom(Vector& rhs) noexcept(kNothrowRelocateInline) {
+        std::destroy_n(Data(), size_);
+        size_ = 0;
+        UnpoisonCapacity();
+        data_ = std::move(rhs.data_);
+        if (data_.IsInline()) {
+            RelocateN(rhs.Data(), rhs.size_, Data());
+            vector_uninitialized::DestroyRelocated(rhs.Data(), rhs.size_);
+        }
+        size_ = std::exchange(rhs.size_, 0);
+        InvalidateIterators();
+        rhs.InvalidateIterators();
+    }
+};
+
+#if ADVANCED_VECTOR_CHECK_LEVEL >= 2
+// Итератор отладочного режима: указатель на элемент, вектор-владелец и поколение его буфера.
+// Разыменование итератора, полученного до смены буфера (перевыделения, Swap, перемещения
+// вектора), или вне элементов вектора останавливает программу. operator-> допускает и end(),
+// чтобы работал std::to_address
+template <typename T, typename Alloc, typename GrowthPolicy, size_t InlineCapacity, typename Stats>
+template <bool IsConst>
+class Vector<T, Alloc, GrowthPolicy, InlineCapacity, Stats>::CheckedIterator {
+    using Owner = std::conditional_t<IsConst, const Vector, Vector>;
+
+    friend class Vector;
+    template <bool>
+    friend class CheckedIterator;
+
+public:
+    using iterator_concept = std::contiguous_iterator_tag;
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<IsConst, const T*, T*>;
+    using reference = std::conditional_t<IsConst, const T&, T&>;
+
+    CheckedIterator() = default;
+
+    constexpr CheckedIterator(Owner* owner, pointer ptr) noexcept
+        : owner_(owner)
+        , ptr_(ptr)
+        , generation_(owner->generation_) {
+    }
+
+    constexpr operator CheckedIterator<true>() const noexcept requires(!IsConst) {
+        CheckedIterator<true> it;
+        it.owner_ = owner_;
+        it.ptr_ = ptr_;
+        it.generation_ = generation_;
+        return it;
+    }
+
+    constexpr reference operator*() const noexcept {
+        CheckGeneration();
+        ADVANCED_VECTOR_CHECK(ptr_ >= owner_->Data() && ptr_ < owner_->Data() + owner_->size_);
+        return *ptr_;
+    }
+
+    constexpr pointer operator->() const noexcept {
+        CheckGeneration();
+        ADVANCED_VECTOR_CHECK(ptr_ >= owner_->Data() && ptr_ <= owner_->Data() + owner_->size_);
+        return ptr_;
+    }
+
+    constexpr reference operator[](difference_type offset) const noexcept {
+        return *(*this + offset);
+    }
+
+    constexpr CheckedIterator& operator++() noexcept {
+        ++ptr_;
+        return *this;
+    }
+
+    constexpr CheckedIterator operator++(int) noexcept {
+        CheckedIterator it = *this;
+        ++ptr_;
+        return it;
+    }
+
+    constexpr CheckedIterator& operator--() noexcept {
+        --ptr_;
+        return *this;
+    }
+
+    constexpr CheckedIterator operator--(int) noexcept {
+        CheckedIterator it = *this;
+        --ptr_;
+        return it;
+    }
+
+    constexpr CheckedIterator& operator+=(difference_type offset) noexcept {
+        ptr_ += offset;
+        return *this;
+    }
+
+    constexpr CheckedIterator& operator-=(difference_type offset) noexcept {
+        ptr_ -= offset;
+        return *this;
+    }
+
+    friend constexpr CheckedIterator operator+(CheckedIterator it, difference_type offset) noexcept {
+        return it += offset;
+    }
+
+    friend constexpr CheckedIterator operator+(difference_type offset, CheckedIterator it) noexcept {
+        return it += offset;
+    }
+
+    friend constexpr CheckedIterator operator-(CheckedIterator it, difference_type offset) noexcept {
+        return it -= offset;
+    }
+
+    friend constexpr difference_type operator-(const CheckedIterator& lhs, const CheckedIterator& rhs) noexcept {
+        ADVANCED_VECTOR_CHECK(lhs.owner_ == rhs.owner_);
+        return lhs.ptr_ - rhs.ptr_;
+    }
+
+    friend constexpr bool operator==(const CheckedIterator& lhs, const CheckedIterator& rhs) noexcept {
+        ADVANCED_VECTOR_CHECK(lhs.owner_ == rhs.owner_);
+        return lhs.ptr_ == rhs.ptr_;
+    }
+
+    friend constexpr auto operator<=>(const CheckedIterator& lhs, const CheckedIterator& rhs) noexcept {
+        ADVANCED_VECTOR_CHECK(lhs.owner_ == rhs.owner_);
+        return lhs.ptr_ <=> rhs.ptr_;
+    }
+
+private:
+    // Буфер вектора не сменился с тех пор, как получен итератор
+    constexpr void CheckGeneration() const noexcept {
+        ADVANCED_VECTOR_CHECK(owner_ != nullptr && owner_->generation_ == generation_);
+    }
+
+    Owner* owner_ = nullptr;
+    pointer ptr_ = nullptr;
+    size_t generation_ = 0;
+};
+#endif
+
+// Вектор, который хранит до N элементов без обращения к куче
+template <typename T, size_t N, typename Alloc = std::allocator<T>, typename GrowthPolicy = DoublingGrowth>
+using SmallVector = Vector<T, Alloc, GrowthPolicy, N>;
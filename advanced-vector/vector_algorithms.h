@@ -0,0 +1,380 @@
+#pragma once
+#include "allocators.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+// Векторизованные алгоритмы над Vector с арифметическими элементами (кроме bool): Fill, Sum,
+// Min, Max, Count, Find и Transform. Ядра написаны на векторных расширениях GCC/Clang один раз
+// и собираются под SSE2/NEON (16 байт), AVX2 (32 байта) и AVX-512 (64 байта). Нужная версия
+// выбирается при первом вызове по возможностям процессора. Если буфер вектора выровнен
+// AlignedAllocator не слабее ширины регистра, ядра читают память выровненными загрузками
+
+namespace vector_simd {
+
+template <typename Alloc>
+inline constexpr size_t kAllocatorAlignment = alignof(typename std::allocator_traits<Alloc>::value_type);
+
+template <typename T, size_t Alignment, bool PadToAlignment>
+inline constexpr size_t kAllocatorAlignment<AlignedAllocator<T, Alignment, PadToAlignment>> = Alignment;
+
+template <typename V>
+struct VectorTraits : std::false_type {
+};
+
+template <typename T, typename Alloc, typename GrowthPolicy, size_t InlineCapacity, typename Stats>
+struct VectorTraits<Vector<T, Alloc, GrowthPolicy, InlineCapacity, Stats>>
+    : std::bool_constant<std::is_arithmetic_v<T> && !std::is_same_v<T, bool>> {
+    using value_type = T;
+    // Встроенный буфер SmallVector выровнен только по alignof(T)
+    static constexpr size_t kAlignment = InlineCapacity == 0 ? kAllocatorAlignment<Alloc> : alignof(T);
+};
+
+enum class Isa {
+    kGeneric,
+    kAvx2,
+    kAvx512,
+};
+
+inline Isa DetectIsa() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    static const Isa isa = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+            return Isa::kAvx512;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            return Isa::kAvx2;
+        }
+        return Isa::kGeneric;
+    }();
+    return isa;
+#else
+    return Isa::kGeneric;
+#endif
+}
+
+// Обёртка над ядром для регистров шириной Bytes байт. Регистры шире 16 байт не передаются
+// и не возвращаются по значению: без включённого AVX это меняет ABI функции, и GCC
+// предупреждает -Wpsabi в каждой единице трансляции, подключившей заголовок
+template <typename T, size_t Bytes, size_t Alignment>
+struct Lanes {
+    using Vec [[gnu::vector_size(Bytes)]] = T;
+    using Mask = decltype(Vec{} == Vec{});
+
+    static constexpr size_t kCount = Bytes / sizeof(T);
+
+    [[gnu::always_inline]] static const T* Assume(const T* data) noexcept {
+        if constexpr (Alignment >= Bytes) {
+            return static_cast<const T*>(__builtin_assume_aligned(data, Bytes));
+        }
+        else {
+            return data;
+        }
+    }
+
+    [[gnu::always_inline]] static T* Assume(T* data) noexcept {
+        return const_cast<T*>(Assume(static_cast<const T*>(data)));
+    }
+
+    [[gnu::always_inline]] static void Load(const T* p, Vec& v) noexcept {
+        std::memcpy(&v, p, Bytes);
+    }
+
+    [[gnu::always_inline]] static void Store(T* p, const Vec& v) noexcept {
+        std::memcpy(p, &v, Bytes);
+    }
+
+    [[gnu::always_inline]] static void Splat(T value, Vec& v) noexcept {
+        v = Vec{} + value;
+    }
+
+    [[gnu::always_inline]] static bool Any(const Mask& m) noexcept {
+        constexpr Mask zero{};
+        return std::memcmp(&m, &zero, Bytes) != 0;
+    }
+};
+
+struct FillKernel {
+    template <typename L, typename T>
+    [[gnu::always_inline]] static void Run(T* data, size_t n, T value) noexcept {
+        data = L::Assume(data);
+        typename L::Vec v;
+        L::Splat(value, v);
+        size_t i = 0;
+        for (; i + L::kCount <= n; i += L::kCount) {
+            L::Store(data + i, v);
+        }
+        std::fill(data + i, data + n, value);
+    }
+};
+
+// Редукция по операции Op: Sum, Min и Max
+template <typename Op>
+struct ReduceKernel {
+    template <typename L, typename T>
+    [[gnu::always_inline]] static T Run(const T* data, size_t n, T init) noexcept {
+        data = L::Assume(data);
+        size_t i = 0;
+        T result = init;
+        if (n >= 2 * L::kCount) {
+            // Два независимых аккумулятора скрывают задержку операции
+            typename L::Vec acc0, acc1, next0, next1;
+            L::Load(data, acc0);
+            L::Load(data + L::kCount, acc1);
+            for (i = 2 * L::kCount; i + 2 * L::kCount <= n; i += 2 * L::kCount) {
+                L::Load(data + i, next0);
+                L::Load(data + i + L::kCount, next1);
+                Op::Apply(acc0, next0);
+                Op::Apply(acc1, next1);
+            }
+            Op::Apply(acc0, acc1);
+            for (size_t lane = 0; lane < L::kCount; ++lane) {
+                Op::Apply(result, static_cast<T>(acc0[lane]));
+            }
+        }
+        for (; i < n; ++i) {
+            Op::Apply(result, data[i]);
+        }
+        return result;
+    }
+};
+
+// Операции редукции накапливают результат в acc: и для регистров, и для отдельных элементов
+struct PlusOp {
+    template <typename V>
+    [[gnu::always_inline]] static void Apply(V& acc, const V& value) noexcept {
+        acc = acc + value;
+    }
+};
+
+struct MinOp {
+    template <typename V>
+    [[gnu::always_inline]] static void Apply(V& acc, const V& value) noexcept {
+        acc = value < acc ? value : acc;
+    }
+};
+
+struct MaxOp {
+    template <typename V>
+    [[gnu::always_inline]] static void Apply(V& acc, const V& value) noexcept {
+        acc = acc < value ? value : acc;
+    }
+};
+
+struct CountKernel {
+    template <typename L, typename T>
+    [[gnu::always_inline]] static size_t Run(const T* data, size_t n, T value) noexcept {
+        data = L::Assume(data);
+        typename L::Vec v, chunk;
+        L::Splat(value, v);
+        size_t result = 0;
+        size_t i = 0;
+        while (i + L::kCount <= n) {
+            // Совпадения дают в маске -1. Счётчики в дорожках копятся не дольше 127 итераций,
+            // чтобы не переполнились и для однобайтных типов
+            typename L::Mask counts{};
+            for (size_t step = 0; step < 127 && i + L::kCount <= n; ++step, i += L::kCount) {
+                L::Load(data + i, chunk);
+                counts -= chunk == v;
+            }
+            for (size_t lane = 0; lane < L::kCount; ++lane) {
+                result += static_cast<size_t>(counts[lane]);
+            }
+        }
+        for (; i < n; ++i) {
+            result += data[i] == value;
+        }
+        return result;
+    }
+};
+
+struct FindKernel {
+    template <typename L, typename T>
+    [[gnu::always_inline]] static size_t Run(const T* data, size_t n, T value) noexcept {
+        data = L::Assume(data);
+        typename L::Vec v, chunk;
+        L::Splat(value, v);
+        size_t i = 0;
+        for (; i + L::kCount <= n; i += L::kCount) {
+            L::Load(data + i, chunk);
+            if (L::Any(chunk == v)) {
+                break;
+            }
+        }
+        for (; i < n; ++i) {
+            if (data[i] == value) {
+                return i;
+            }
+        }
+        return n;
+    }
+};
+
+// Применяет op к каждому элементу. При ByLanes op вызывается для 16-байтных регистров
+// (см. TransformLanes), а по одному — только для элементов хвоста. Более широкие регистры
+// в op не передаются: их передача по значению меняет ABI вызова пользовательской функции
+template <bool ByLanes>
+struct TransformKernel {
+    template <typename L, typename T, typename Op>
+    [[gnu::always_inline]] static void Run(const T* src, T* dest, size_t n, Op& op) {
+        using Narrow = Lanes<T, 16, 0>;
+        src = L::Assume(src);
+        dest = L::Assume(dest);
+        size_t i = 0;
+        if constexpr (ByLanes) {
+            typename Narrow::Vec chunk;
+            for (; i + Narrow::kCount <= n; i += Narrow::kCount) {
+                Narrow::Load(src + i, chunk);
+                Narrow::Store(dest + i, static_cast<typename Narrow::Vec>(op(chunk)));
+            }
+        }
+        for (; i < n; ++i) {
+            dest[i] = static_cast<T>(op(src[i]));
+        }
+    }
+};
+
+template <typename Kernel, typename T, size_t Alignment, typename... Args>
+#if defined(__x86_64__) || defined(__i386__)
+[[gnu::target("avx512f,avx512bw")]]
+#endif
+auto RunAvx512(Args&&... args) {
+    return Kernel::template Run<Lanes<T, 64, Alignment>>(std::forward<Args>(args)...);
+}
+
+template <typename Kernel, typename T, size_t Alignment, typename... Args>
+#if defined(__x86_64__) || defined(__i386__)
+[[gnu::target("avx2")]]
+#endif
+auto RunAvx2(Args&&... args) {
+    return Kernel::template Run<Lanes<T, 32, Alignment>>(std::forward<Args>(args)...);
+}
+
+template <typename Kernel, typename T, size_t Alignment, typename... Args>
+auto RunGeneric(Args&&... args) {
+    return Kernel::template Run<Lanes<T, 16, Alignment>>(std::forward<Args>(args)...);
+}
+
+// Запускает ядро с самыми широкими регистрами, которые поддерживает процессор
+template <typename Kernel, typename T, size_t Alignment, typename... Args>
+auto Run(Args&&... args) {
+    switch (DetectIsa()) {
+    case Isa::kAvx512:
+        return RunAvx512<Kernel, T, Alignment>(std::forward<Args>(args)...);
+    case Isa::kAvx2:
+        return RunAvx2<Kernel, T, Alignment>(std::forward<Args>(args)...);
+    default:
+        return RunGeneric<Kernel, T, Alignment>(std::forward<Args>(args)...);
+    }
+}
+
+}  // namespace vector_simd
+
+template <typename V>
+concept SimdVector = vector_simd::VectorTraits<V>::value;
+
+// Присваивает value всем элементам вектора
+template <SimdVector V>
+void Fill(V& v, typename V::value_type value) noexcept {
+    using Traits = vector_simd::VectorTraits<V>;
+    vector_simd::Run<vector_simd::FillKernel, typename Traits::value_type, Traits::kAlignment>(v.Data(), v.Size(), value);
+}
+
+// Сумма элементов в типе элемента. Для чисел с плавающей точкой слагаемые суммируются
+// в другом порядке, чем при последовательном обходе
+template <SimdVector V>
+typename V::value_type Sum(const V& v) noexcept {
+    using Traits = vector_simd::VectorTraits<V>;
+    using T = typename Traits::value_type;
+    if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+        // Знаковые целые складываются как беззнаковые: переполнение тогда определено
+        using U = std::make_unsigned_t<T>;
+        return static_cast<T>(vector_simd::Run<vector_simd::ReduceKernel<vector_simd::PlusOp>, U, Traits::kAlignment>(
+            reinterpret_cast<const U*>(v.Data()), v.Size(), U{}));
+    }
+    else {
+        return vector_simd::Run<vector_simd::ReduceKernel<vector_simd::PlusOp>, T, Traits::kAlignment>(v.Data(), v.Size(), T{});
+    }
+}
+
+// Наименьший элемент непустого вектора
+template <SimdVector V>
+typename V::value_type Min(const V& v) noexcept {
+    assert(v.Size() != 0);
+    using Traits = vector_simd::VectorTraits<V>;
+    return vector_simd::Run<vector_simd::ReduceKernel<vector_simd::MinOp>, typename Traits::value_type, Traits::kAlignment>(
+        v.Data(), v.Size(), v[0]);
+}
+
+// Наибольший элемент непустого вектора
+template <SimdVector V>
+typename V::value_type Max(const V& v) noexcept {
+    assert(v.Size() != 0);
+    using Traits = vector_simd::VectorTraits<V>;
+    return vector_simd::Run<vector_simd::ReduceKernel<vector_simd::MaxOp>, typename Traits::value_type, Traits::kAlignment>(
+        v.Data(), v.Size(), v[0]);
+}
+
+// Количество элементов, равных value
+template <SimdVector V>
+size_t Count(const V& v, typename V::value_type value) noexcept {
+    using Traits = vector_simd::VectorTraits<V>;
+    return vector_simd::Run<vector_simd::CountKernel, typename Traits::value_type, Traits::kAlignment>(v.Data(), v.Size(), value);
+}
+
+// Первый элемент, равный value, или end()
+template <SimdVector V>
+auto Find(V& v, typename V::value_type value) noexcept {
+    using Traits = vector_simd::VectorTraits<V>;
+    return v.begin()
+           + vector_simd::Run<vector_simd::FindKernel, typename Traits::value_type, Traits::kAlignment>(v.Data(), v.Size(), value);
+}
+
+template <SimdVector V>
+auto Find(const V& v, typename V::value_type value) noexcept {
+    using Traits = vector_simd::VectorTraits<V>;
+    return v.begin()
+           + vector_simd::Run<vector_simd::FindKernel, typename Traits::value_type, Traits::kAlignment>(v.Data(), v.Size(), value);
+}
+
+// 16-байтный регистр из элементов вектора V, который получает op в TransformLanes
+template <SimdVector V>
+using SimdLanes = typename vector_simd::Lanes<typename V::value_type, 16, 0>::Vec;
+
+// Заменяет каждый элемент x на op(x). Цикл векторизует компилятор, если может встроить op
+template <SimdVector V, typename Op>
+void Transform(V& v, Op op) {
+    using Traits = vector_simd::VectorTraits<V>;
+    vector_simd::Run<vector_simd::TransformKernel<false>, typename Traits::value_type, Traits::kAlignment>(
+        static_cast<const typename Traits::value_type*>(v.Data()), v.Data(), v.Size(), op);
+}
+
+// Записывает в dest значения op(x) для всех элементов src, dest принимает размер src
+template <SimdVector V, typename Op>
+void Transform(const V& src, V& dest, Op op) {
+    using Traits = vector_simd::VectorTraits<V>;
+    dest.ResizeDefaultInit(src.Size());
+    vector_simd::Run<vector_simd::TransformKernel<false>, typename Traits::value_type, Traits::kAlignment>(
+        src.Data(), dest.Data(), src.Size(), op);
+}
+
+// Transform, который передаёт в op сразу регистр SimdLanes<V>. op должен принимать и регистр,
+// и отдельный элемент для хвоста, как обобщённая лямбда с арифметикой: [](auto x) { return x * 2; }
+template <SimdVector V, typename Op>
+void TransformLanes(V& v, Op op) {
+    using Traits = vector_simd::VectorTraits<V>;
+    vector_simd::Run<vector_simd::TransformKernel<true>, typename Traits::value_type, Traits::kAlignment>(
+        static_cast<const typename Traits::value_type*>(v.Data()), v.Data(), v.Size(), op);
+}
+
+template <SimdVector V, typename Op>
+void TransformLanes(const V& src, V& dest, Op op) {
+    using Traits = vector_simd::VectorTraits<V>;
+    dest.ResizeDefaultInit(src.Size());
+    vector_simd::Run<vector_simd::TransformKernel<true>, typename Traits::value_type, Traits::kAlignment>(
+        src.Data(), dest.Data(), src.Size(), op);
+}
@@ -0,0 +1,304 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+// Двоичный формат Vector: заголовок VectorHeader, нули до data_offset и элементы.
+// Тривиально копируемые элементы записываются байтами памяти вектора одним вызовом, а
+// VectorView читает их прямо из полученного буфера без копирования. Порядок байт и
+// представление элементов не преобразуются: формат рассчитан на обмен между одинаковыми
+// сборками. Для остальных типов нужна специализация VectorElementCodec
+
+inline constexpr uint32_t kVectorFormatMagic = 0x43455641;  // "AVEC" в little-endian
+inline constexpr uint32_t kSwappedVectorFormatMagic = 0x41564543;
+inline constexpr uint16_t kVectorFormatVersion = 1;
+
+enum class VectorPayload : uint8_t {
+    // Байты элементов подряд, начиная с data_offset
+    kRaw,
+    // Элементы, записанные по одному через VectorElementCodec
+    kPerElement,
+};
+
+struct VectorHeader {
+    uint32_t magic;
+    uint16_t version;
+    VectorPayload payload;
+    uint8_t reserved;
+    uint32_t element_size;
+    // Смещение первого элемента от начала заголовка, кратное alignof(T)
+    uint32_t data_offset;
+    uint64_t count;
+};
+
+static_assert(sizeof(VectorHeader) == 24 && std::is_trivially_copyable_v<VectorHeader>);
+
+class SerializationError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// Приёмник байтов: Write(std::span<const std::byte>) записывает их целиком
+template <typename Writer>
+concept ByteWriter = requires(Writer& writer, std::span<const std::byte> bytes) {
+    writer.Write(bytes);
+};
+
+// Приёмник, записывающий несколько кусков одним вызовом (как writev)
+template <typename Writer>
+concept GatherByteWriter = ByteWriter<Writer> && requires(Writer& writer, std::span<const std::span<const std::byte>> parts) {
+    writer.WriteGather(parts);
+};
+
+// Источник байтов: Read(std::span<std::byte>) заполняет буфер целиком или бросает исключение
+template <typename Reader>
+concept ByteReader = requires(Reader& reader, std::span<std::byte> bytes) {
+    reader.Read(bytes);
+};
+
+// Источник, который знает, сколько байт в нём осталось: Remaining() возвращает непрочитанный остаток
+template <typename Reader>
+concept SizedByteReader = ByteReader<Reader> && requires(const Reader& reader) {
+    { reader.Remaining().size() } -> std::convertible_to<size_t>;
+};
+
+// Кодек для элементов, которые нельзя записать байтами памяти. Специализация должна
+// предоставить static void Write(ByteWriter auto&, const T&) и static T Read(ByteReader auto&)
+template <typename T>
+struct VectorElementCodec;
+
+// Дописывает байты в конец Vector<std::byte>
+class BufferWriter {
+public:
+    explicit BufferWriter(Vector<std::byte>& buffer) noexcept
+        : buffer_(&buffer) {
+    }
+
+    void Write(std::span<const std::byte> bytes) {
+        buffer_->Append(bytes);
+    }
+
+    void WriteGather(std::span<const std::span<const std::byte>> parts) {
+        size_t total = buffer_->Size();
+        for (const auto& part : parts) {
+            total += part.size();
+        }
+        buffer_->Reserve(total);
+        for (const auto& part : parts) {
+            buffer_->Append(part);
+        }
+    }
+
+private:
+    Vector<std::byte>* buffer_;
+};
+
+// Читает байты из буфера по порядку
+class BufferReader {
+public:
+    explicit BufferReader(std::span<const std::byte> buffer) noexcept
+        : buffer_(buffer) {
+    }
+
+    void Read(std::span<std::byte> bytes) {
+        if (bytes.size() > buffer_.size()) {
+            throw SerializationError("unexpected end of serialized vector");
+        }
+        if (!bytes.empty()) {
+            std::memcpy(bytes.data(), buffer_.data(), bytes.size());
+        }
+        buffer_ = buffer_.subspan(bytes.size());
+    }
+
+    // Непрочитанный остаток буфера
+    std::span<const std::byte> Remaining() const noexcept {
+        return buffer_;
+    }
+
+private:
+    std::span<const std::byte> buffer_;
+};
+
+namespace vector_serialization {
+
+template <typename T>
+inline constexpr bool kRawPayload = std::is_trivially_copyable_v<T>;
+
+// Число элементов в заголовке не проверено, поэтому источник без Remaining() читается
+// кусками не больше этого размера: память растёт вместе с действительно прочитанными
+// байтами, а обрыв данных завершается SerializationError, а не огромным выделением
+inline constexpr size_t kReadChunkBytes = size_t{1} << 20;
+
+template <typename T>
+constexpr size_t ReadChunkElements() noexcept {
+    return sizeof(T) < kReadChunkBytes ? kReadChunkBytes / sizeof(T) : 1;
+}
+
+template <typename T>
+constexpr uint32_t DataOffset() noexcept {
+    return static_cast<uint32_t>((sizeof(VectorHeader) + alignof(T) - 1) / alignof(T) * alignof(T));
+}
+
+template <typename T>
+VectorHeader MakeHeader(size_t count) noexcept {
+    return {kVectorFormatMagic, kVectorFormatVersion, kRawPayload<T> ? VectorPayload::kRaw : VectorPayload::kPerElement, 0,
+            static_cast<uint32_t>(sizeof(T)), kRawPayload<T> ? DataOffset<T>() : uint32_t{sizeof(VectorHeader)}, count};
+}
+
+// Проверяет, что заголовок описывает элементы T, и возвращает число элементов
+template <typename T>
+size_t CheckHeader(const VectorHeader& header) {
+    if (header.magic != kVectorFormatMagic) {
+        throw SerializationError(header.magic == kSwappedVectorFormatMagic ? "serialized vector has foreign byte order"
+                                                                            : "not a serialized vector");
+    }
+    if (header.version != kVectorFormatVersion) {
+        throw SerializationError("unsupported serialized vector version");
+    }
+    if (header.payload != MakeHeader<T>(0).payload || header.element_size != sizeof(T)
+        || header.data_offset != MakeHeader<T>(0).data_offset) {
+        throw SerializationError("serialized vector has a different element type");
+    }
+    if (header.count > std::numeric_limits<size_t>::max() / sizeof(T)) {
+        throw SerializationError("serialized vector is too large");
+    }
+    return static_cast<size_t>(header.count);
+}
+
+}  // namespace vector_serialization
+
+// Записывает вектор в writer. Элементы тривиально копируемых типов уходят одним куском
+// памяти, а при GatherByteWriter заголовок и элементы записываются одним вызовом
+template <typename T, typename Alloc, typename GrowthPolicy, size_t InlineCapacity, typename Stats, ByteWriter Writer>
+void Serialize(const Vector<T, Alloc, GrowthPolicy, InlineCapacity, Stats>& v, Writer& writer) {
+    const VectorHeader fixed_header = vector_serialization::MakeHeader<T>(v.Size());
+    std::byte header[vector_serialization::DataOffset<T>()] = {};
+    std::memcpy(header, &fixed_header, sizeof(fixed_header));
+    const std::span<const std::byte> header_bytes(header, fixed_header.data_offset);
+    if constexpr (vector_serialization::kRawPayload<T>) {
+        const std::span<const std::byte> data_bytes = std::as_bytes(std::span(v.Data(), v.Size()));
+        if constexpr (GatherByteWriter<Writer>) {
+            const std::span<const std::byte> parts[] = {header_bytes, data_bytes};
+            writer.WriteGather(parts);
+        }
+        else {
+            writer.Write(header_bytes);
+            writer.Write(data_bytes);
+        }
+    }
+    else {
+        static_assert(requires(const T& value) { VectorElementCodec<T>::Write(writer, value); },
+                      "non-trivially copyable T needs a VectorElementCodec<T> specialization");
+        writer.Write(header_bytes);
+        for (const T& value : v) {
+            VectorElementCodec<T>::Write(writer, value);
+        }
+    }
+}
+
+// Заменяет содержимое out вектором из reader. Байты элементов тривиально копируемых
+// типов читаются прямо в буфер out без промежуточной копии. Размер из заголовка
+// сверяется с остатком SizedByteReader до выделения памяти, а из других источников
+// элементы читаются кусками (см. kReadChunkBytes). Если чтение прервётся
+// исключением, out останется в корректном, но неопределённом состоянии
+template <typename T, typename Alloc, typename GrowthPolicy, size_t InlineCapacity, typename Stats, ByteReader Reader>
+void Deserialize(Reader& reader, Vector<T, Alloc, GrowthPolicy, InlineCapacity, Stats>& out) {
+    VectorHeader header;
+    reader.Read(std::as_writable_bytes(std::span(&header, 1)));
+    const size_t count = vector_serialization::CheckHeader<T>(header);
+    if constexpr (vector_serialization::kRawPayload<T>) {
+        std::byte padding[vector_serialization::DataOffset<T>() - sizeof(VectorHeader) + 1];
+        reader.Read(std::span(padding, header.data_offset - sizeof(VectorHeader)));
+        if constexpr (SizedByteReader<Reader>) {
+            if (count > reader.Remaining().size() / sizeof(T)) {
+                throw SerializationError("unexpected end of serialized vector");
+            }
+            out.ResizeDefaultInit(count);
+            reader.Read(std::as_writable_bytes(std::span(out.Data(), count)));
+        }
+        else {
+            out.Clear();
+            while (out.Size() < count) {
+                const size_t offset = out.Size();
+                const size_t chunk = std::min(count - offset, vector_serialization::ReadChunkElements<T>());
+                out.ResizeDefaultInit(offset + chunk);
+                reader.Read(std::as_writable_bytes(std::span(out.Data() + offset, chunk)));
+            }
+        }
+    }
+    else {
+        out.Clear();
+        // Каждый элемент может занимать в потоке сколько угодно байт, поэтому заранее
+        // резервируется не больше одного куска
+        out.Reserve(std::min(count, vector_serialization::ReadChunkElements<T>()));
+        for (size_t i = 0; i < count; ++i) {
+            out.PushBack(VectorElementCodec<T>::Read(reader));
+        }
+    }
+}
+
+// Вектор тривиально копируемых T, прочитанный из буфера с результатом Serialize без
+// копирования. Буфер должен быть выровнен по alignof(T) и жить дольше представления
+template <typename T>
+class VectorView {
+    static_assert(vector_serialization::kRawPayload<T>, "VectorView needs trivially copyable T");
+
+public:
+    using value_type = T;
+    using iterator = const T*;
+    using const_iterator = const T*;
+
+    VectorView() = default;
+
+    explicit VectorView(std::span<const std::byte> buffer) {
+        VectorHeader header;
+        if (buffer.size() < sizeof(header)) {
+            throw SerializationError("unexpected end of serialized vector");
+        }
+        std::memcpy(&header, buffer.data(), sizeof(header));
+        size_ = vector_serialization::CheckHeader<T>(header);
+        if (buffer.size() < header.data_offset || size_ > (buffer.size() - header.data_offset) / sizeof(T)) {
+            throw SerializationError("unexpected end of serialized vector");
+        }
+        const std::byte* data = buffer.data() + header.data_offset;
+        if (reinterpret_cast<uintptr_t>(data) % alignof(T) != 0) {
+            throw SerializationError("serialized vector buffer is misaligned");
+        }
+        data_ = reinterpret_cast<const T*>(data);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    const_iterator begin() const noexcept {
+        return data_;
+    }
+
+    const_iterator end() const noexcept {
+        return data_ + size_;
+    }
+
+    // Число байт буфера, занятых заголовком и элементами
+    size_t SerializedSize() const noexcept {
+        return vector_serialization::DataOffset<T>() + size_ * sizeof(T);
+    }
+
+private:
+    const T* data_ = nullptr;
+    size_t size_ = 0;
+};
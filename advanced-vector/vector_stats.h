@@ -0,0 +1,113 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <utility>
+
+// Снимок счётчиков CountingVectorStats
+struct VectorStatsSnapshot {
+    static constexpr size_t kSizeBuckets = 65;
+
+    size_t allocations = 0;
+    size_t allocated_bytes = 0;
+    size_t realocations = 0;
+    size_t moved_elements = 0;
+    size_t copied_elements = 0;
+    size_t peak_capacity = 0;
+    // Гистограмма размеров векторов при уничтожении: final_sizes[0] — пустые векторы с буфером
+    // в куче, final_sizes[k] — векторы размером от 2^(k-1) до 2^k - 1. Векторы без элементов
+    // и без буфера, например оставшиеся после перемещения, не учитываются
+    std::array<size_t, kSizeBuckets> final_sizes{};
+};
+
+// Политика статистики для RawMemory и Vector, считающая события в атомарных счётчиках.
+// Счётчики общие для всех векторов с одним Tag: так подсистемы ведут статистику раздельно.
+// Скопированные элементы стоит отслеживать отдельно: их появление значит, что у T нет
+// noexcept-конструктора перемещения и вектор растёт копированием
+template <typename Tag = void>
+class CountingVectorStats {
+public:
+    using Exporter = std::function<void(const VectorStatsSnapshot&)>;
+
+    static void OnAllocate(size_t count, size_t bytes) noexcept {
+        counters_.allocations.fetch_add(1, std::memory_order_relaxed);
+        counters_.allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+        size_t peak = counters_.peak_capacity.load(std::memory_order_relaxed);
+        while (peak < count && !counters_.peak_capacity.compare_exchange_weak(peak, count, std::memory_order_relaxed)) {
+        }
+    }
+
+    static void OnRealocate() noexcept {
+        counters_.realocations.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void OnMove(size_t n) noexcept {
+        counters_.moved_elements.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    static void OnCopy(size_t n) noexcept {
+        counters_.copied_elements.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    static void OnDestroy(size_t size) noexcept {
+        counters_.final_sizes[std::bit_width(size)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static VectorStatsSnapshot Snapshot() noexcept {
+        VectorStatsSnapshot snapshot;
+        snapshot.allocations = counters_.allocations.load(std::memory_order_relaxed);
+        snapshot.allocated_bytes = counters_.allocated_bytes.load(std::memory_order_relaxed);
+        snapshot.realocations = counters_.realocations.load(std::memory_order_relaxed);
+        snapshot.moved_elements = counters_.moved_elements.load(std::memory_order_relaxed);
+        snapshot.copied_elements = counters_.copied_elements.load(std::memory_order_relaxed);
+        snapshot.peak_capacity = counters_.peak_capacity.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < VectorStatsSnapshot::kSizeBuckets; ++i) {
+            snapshot.final_sizes[i] = counters_.final_sizes[i].load(std::memory_order_relaxed);
+        }
+        return snapshot;
+    }
+
+    static void Reset() noexcept {
+        counters_.allocations.store(0, std::memory_order_relaxed);
+        counters_.allocated_bytes.store(0, std::memory_order_relaxed);
+        counters_.realocations.store(0, std::memory_order_relaxed);
+        counters_.moved_elements.store(0, std::memory_order_relaxed);
+        counters_.copied_elements.store(0, std::memory_order_relaxed);
+        counters_.peak_capacity.store(0, std::memory_order_relaxed);
+        for (auto& bucket : counters_.final_sizes) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Устанавливает функцию, которой Export передаёт снимок счётчиков
+    static void SetExporter(Exporter exporter) {
+        std::lock_guard guard(exporter_mutex_);
+        exporter_ = std::move(exporter);
+    }
+
+    // Передаёт текущий снимок счётчиков экспортёру, если он установлен
+    static void Export() {
+        std::lock_guard guard(exporter_mutex_);
+        if (exporter_) {
+            exporter_(Snapshot());
+        }
+    }
+
+private:
+    struct Counters {
+        std::atomic<size_t> allocations{0};
+        std::atomic<size_t> allocated_bytes{0};
+        std::atomic<size_t> realocations{0};
+        std::atomic<size_t> moved_elements{0};
+        std::atomic<size_t> copied_elements{0};
+        std::atomic<size_t> peak_capacity{0};
+        std::array<std::atomic<size_t>, VectorStatsSnapshot::kSizeBuckets> final_sizes{};
+    };
+
+    static inline Counters counters_;
+    static inline std::mutex exporter_mutex_;
+    static inline Exporter exporter_;
+};
@@ -0,0 +1,214 @@
+#include "vector.h"
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Элемент с копированием, которое может бросить исключение, и без noexcept-перемещения:
+// при росте Vector вынужден копировать такие элементы
+struct ThrowingCopy {
+    explicit ThrowingCopy(int value)
+        : value(std::to_string(value)) {
+    }
+
+    ThrowingCopy(const ThrowingCopy& other)
+        : value(other.value) {
+    }
+
+    ThrowingCopy& operator=(const ThrowingCopy& rhs) {
+        value = rhs.value;
+        return *this;
+    }
+
+    std::string value;
+};
+
+// Тяжёлый тривиально копируемый элемент
+struct Large {
+    explicit Large(int value) {
+        data.fill(value);
+    }
+
+    std::array<int, 64> data;
+};
+
+template <typename T>
+T MakeValue(int i) {
+    if constexpr (std::is_same_v<T, std::string>) {
+        return std::to_string(i) + std::string(24, 'x');
+    }
+    else {
+        return T(i);
+    }
+}
+
+// Операции, общие для Vector и std::vector
+
+template <typename T>
+void PushBack(Vector<T>& v, const T& value) {
+    v.PushBack(value);
+}
+
+template <typename T>
+void PushBack(std::vector<T>& v, const T& value) {
+    v.push_back(value);
+}
+
+template <typename T>
+void EmplaceBack(Vector<T>& v, int i) {
+    v.EmplaceBack(MakeValue<T>(i));
+}
+
+template <typename T>
+void EmplaceBack(std::vector<T>& v, int i) {
+    v.emplace_back(MakeValue<T>(i));
+}
+
+template <typename T>
+void Reserve(Vector<T>& v, size_t capacity) {
+    v.Reserve(capacity);
+}
+
+template <typename T>
+void Reserve(std::vector<T>& v, size_t capacity) {
+    v.reserve(capacity);
+}
+
+template <typename T>
+void InsertAt(Vector<T>& v, size_t index, const T& value) {
+    v.Insert(v.begin() + index, value);
+}
+
+template <typename T>
+void InsertAt(std::vector<T>& v, size_t index, const T& value) {
+    v.insert(v.begin() + index, value);
+}
+
+template <typename T>
+void EraseAt(Vector<T>& v, size_t index) {
+    v.Erase(v.begin() + index);
+}
+
+template <typename T>
+void EraseAt(std::vector<T>& v, size_t index) {
+    v.erase(v.begin() + index);
+}
+
+template <typename Container>
+Container MakeContainer(size_t size) {
+    using T = std::remove_cvref_t<decltype(*std::declval<Container>().begin())>;
+    Container c;
+    Reserve(c, size);
+    for (size_t i = 0; i < size; ++i) {
+        PushBack(c, MakeValue<T>(static_cast<int>(i)));
+    }
+    return c;
+}
+
+template <typename Container, typename T>
+void BM_PushBack(benchmark::State& state) {
+    const auto size = static_cast<size_t>(state.range(0));
+    const T value = MakeValue<T>(42);
+    for (auto _ : state) {
+        Container c;
+        for (size_t i = 0; i < size; ++i) {
+            PushBack(c, value);
+        }
+        benchmark::DoNotOptimize(c);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Container, typename T>
+void BM_EmplaceBack(benchmark::State& state) {
+    const auto size = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        Container c;
+        for (int i = 0; i < size; ++i) {
+            EmplaceBack(c, i);
+        }
+        benchmark::DoNotOptimize(c);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Container, typename T>
+void BM_ReserveThenPushBack(benchmark::State& state) {
+    const auto size = static_cast<size_t>(state.range(0));
+    const T value = MakeValue<T>(42);
+    for (auto _ : state) {
+        Container c;
+        Reserve(c, size);
+        for (size_t i = 0; i < size; ++i) {
+            PushBack(c, value);
+        }
+        benchmark::DoNotOptimize(c);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Вставка и удаление в середине одного и того же вектора: размер не меняется
+template <typename Container, typename T>
+void BM_InsertEraseMiddle(benchmark::State& state) {
+    const auto size = static_cast<size_t>(state.range(0));
+    Container c = MakeContainer<Container>(size);
+    Reserve(c, size + 1);
+    const T value = MakeValue<T>(42);
+    for (auto _ : state) {
+        InsertAt(c, size / 2, value);
+        EraseAt(c, size / 2);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// Копирующее присваивание в вектор достаточной вместимости (Vector::AllocateOnCapacity)
+template <typename Container, typename T>
+void BM_CopyAssignOnCapacity(benchmark::State& state) {
+    const auto size = static_cast<size_t>(state.range(0));
+    const Container src = MakeContainer<Container>(size);
+    Container dst = MakeContainer<Container>(size);
+    for (auto _ : state) {
+        dst = src;
+        benchmark::DoNotOptimize(dst);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Container, typename T>
+void BM_Move(benchmark::State& state) {
+    Container c = MakeContainer<Container>(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        Container moved(std::move(c));
+        c = std::move(moved);
+        benchmark::DoNotOptimize(c);
+    }
+}
+
+constexpr int64_t kMinSize = 8;
+constexpr int64_t kMaxSize = 8 << 10;
+
+#define VECTOR_BENCHMARK(func, type)                                                                     \
+    BENCHMARK_TEMPLATE(func, std::vector<type>, type)->RangeMultiplier(8)->Range(kMinSize, kMaxSize);  \
+    BENCHMARK_TEMPLATE(func, Vector<type>, type)->RangeMultiplier(8)->Range(kMinSize, kMaxSize)
+
+#define VECTOR_BENCHMARKS(type)                      \
+    VECTOR_BENCHMARK(BM_PushBack, type);             \
+    VECTOR_BENCHMARK(BM_EmplaceBack, type);          \
+    VECTOR_BENCHMARK(BM_ReserveThenPushBack, type);  \
+    VECTOR_BENCHMARK(BM_InsertEraseMiddle, type);    \
+    VECTOR_BENCHMARK(BM_CopyAssignOnCapacity, type); \
+    VECTOR_BENCHMARK(BM_Move, type)
+
+VECTOR_BENCHMARKS(int);
+VECTOR_BENCHMARKS(std::string);
+VECTOR_BENCHMARKS(ThrowingCopy);
+VECTOR_BENCHMARKS(Large);
+
+}  // namespace
+
+BENCHMARK_MAIN();
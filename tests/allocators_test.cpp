@@ -0,0 +1,67 @@
+#include "allocators.h"
+
+#include "vector.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <numeric>
+
+namespace {
+
+bool IsAligned(const void* p, size_t alignment) {
+    return reinterpret_cast<uintptr_t>(p) % alignment == 0;
+}
+
+// Блок округляется до кратного Alignment, и allocate_at_least отдаёт его целиком
+TEST(AlignedAllocator, PadsBlockToAlignment) {
+    AlignedAllocator<float, 32> alloc;
+    const auto result = alloc.allocate_at_least(5);
+    EXPECT_TRUE(IsAligned(result.ptr, 32));
+    EXPECT_EQ(result.count, 8u);
+    alloc.deallocate(result.ptr, result.count);
+}
+
+TEST(AlignedAllocator, VectorKeepsAlignmentWhileGrowing) {
+    Vector<double, AlignedAllocator<double>> v;
+    v.Reserve(3);
+    EXPECT_EQ(v.Capacity() * sizeof(double) % kCacheLineSize, 0u);
+    for (int i = 0; i < 1000; ++i) {
+        v.PushBack(i);
+        ASSERT_TRUE(IsAligned(v.Data(), kCacheLineSize));
+    }
+    const Vector<double, AlignedAllocator<double>> copy = v;
+    EXPECT_TRUE(IsAligned(copy.Data(), kCacheLineSize));
+    EXPECT_EQ(std::accumulate(copy.begin(), copy.end(), 0.0), 999.0 * 1000 / 2);
+}
+
+TEST(AlignedAllocator, UnpaddedBlockAndOverflow) {
+    AlignedAllocator<int, 64, false> alloc;
+    int* p = alloc.allocate(1);
+    EXPECT_TRUE(IsAligned(p, 64));
+    alloc.deallocate(p, 1);
+    EXPECT_THROW(alloc.allocate(std::numeric_limits<size_t>::max() / sizeof(int)), std::bad_array_new_length);
+}
+
+// Тривиально перемещаемые элементы переносятся через realloc и сохраняют значения
+TEST(MallocAllocator, VectorGrowsThroughRealloc) {
+    MallocAllocator<int> alloc;
+    const auto result = alloc.allocate_at_least(3);
+    EXPECT_GE(result.count, 3u);
+    alloc.deallocate(result.ptr, result.count);
+
+    Vector<int, MallocAllocator<int>> v;
+    for (int i = 0; i < 100000; ++i) {
+        v.PushBack(i);
+    }
+    EXPECT_EQ(std::accumulate(v.begin(), v.end(), int64_t{0}), int64_t{99999} * 100000 / 2);
+    v.Resize(10);
+    v.ShrinkToFit();
+    EXPECT_GE(v.Capacity(), 10u);
+    EXPECT_EQ(v[9], 9);
+    EXPECT_THROW(alloc.allocate(std::numeric_limits<size_t>::max() / sizeof(int) + 1), std::bad_array_new_length);
+}
+
+}  // namespace
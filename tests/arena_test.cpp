@@ -0,0 +1,85 @@
+#include "arena.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+
+namespace {
+
+bool IsInside(const void* p, size_t bytes, const std::byte* first, const std::byte* last) {
+    const auto* begin = static_cast<const std::byte*>(p);
+    return begin >= first && begin + bytes <= last;
+}
+
+bool IsAligned(const void* p, size_t alignment) {
+    return reinterpret_cast<uintptr_t>(p) % alignment == 0;
+}
+
+// После выделения почти всего буфера нечётного размера выровненный адрес оказывается
+// за концом буфера: арена должна перейти к новому блоку, а не выдать память за ним.
+// Буфер арены — начало большего массива, чтобы выход за его конец был виден
+TEST(MonotonicArena, OddSizedBufferDoesNotOverflow) {
+    alignas(8) std::array<std::byte, 256> storage;
+    MonotonicArena arena{std::span<std::byte>(storage).first(98)};
+    void* head = arena.Allocate(97, 1);
+    EXPECT_EQ(head, storage.data());
+    void* tail = arena.Allocate(8, 8);
+    EXPECT_TRUE(IsAligned(tail, 8));
+    EXPECT_FALSE(IsInside(tail, 1, storage.data(), storage.data() + storage.size()));
+}
+
+// Блок из кучи подбирается точно под запрос; следующее выровненное выделение не должно
+// выйти за его конец
+TEST(MonotonicArena, ExactFitHeapBlockDoesNotOverflow) {
+    MonotonicArena arena(16);
+    void* big = arena.Allocate(1001, 1);
+    void* first = arena.Allocate(16, 16);
+    void* second = arena.Allocate(16, 16);
+    EXPECT_TRUE(IsAligned(first, 16));
+    EXPECT_TRUE(IsAligned(second, 16));
+    EXPECT_NE(big, first);
+    EXPECT_NE(first, second);
+    std::memset(first, 0xAB, 16);
+    std::memset(second, 0xCD, 16);
+}
+
+TEST(MonotonicArena, ExpandAndRelease) {
+    alignas(16) std::array<std::byte, 256> buffer;
+    MonotonicArena arena(buffer);
+    void* p = arena.Allocate(32, 16);
+    EXPECT_TRUE(arena.Expand(p, 32, 200));
+    EXPECT_FALSE(arena.Expand(p, 200, 300));
+    void* other = arena.Allocate(8, 8);
+    EXPECT_FALSE(arena.Expand(p, 200, 210));
+    EXPECT_TRUE(IsInside(other, 8, buffer.data(), buffer.data() + buffer.size()));
+    arena.Release();
+    EXPECT_EQ(arena.Allocate(1, 1), buffer.data());
+}
+
+TEST(ArenaVector, GrowsInPlaceAndRoundTrips) {
+    alignas(16) std::array<std::byte, 4096> buffer;
+    MonotonicArena arena(buffer);
+    ArenaVector<int> v(arena);
+    v.Reserve(4);
+    const int* data = v.Data();
+    for (int i = 0; i < 100; ++i) {
+        v.PushBack(i);
+    }
+    // Без других выделений между вставками буфер растёт на месте
+    EXPECT_EQ(v.Data(), data);
+    ArenaVector<std::string> names(arena);
+    for (int i = 0; i < 50; ++i) {
+        names.PushBack(std::to_string(i));
+    }
+    ArenaVector<int> moved = std::move(v);
+    ASSERT_EQ(moved.Size(), 100u);
+    EXPECT_EQ(moved[99], 99);
+    EXPECT_EQ(names[49], "49");
+}
+
+}  // namespace
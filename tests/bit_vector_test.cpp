@@ -0,0 +1,139 @@
+#include "bit_vector.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <new>
+#include <random>
+#include <ranges>
+#include <vector>
+
+namespace {
+
+static_assert(std::ranges::random_access_range<BitVector<>>);
+static_assert(std::ranges::random_access_range<const BitVector<>>);
+
+// Размер с неполным последним словом
+constexpr size_t kOddBits = 64 * 5 + 13;
+
+TEST(BitVector, PushBackAndReference) {
+    BitVector<> bits;
+    for (size_t i = 0; i < kOddBits; ++i) {
+        bits.PushBack(i % 3 == 0);
+    }
+    ASSERT_EQ(bits.Size(), kOddBits);
+    EXPECT_EQ(bits.Capacity() % 64, 0u);
+    EXPECT_TRUE(bits[0]);
+    EXPECT_FALSE(bits[1]);
+    bits[1] = true;
+    bits[0].Flip();
+    bits[2] = bits[1];
+    EXPECT_FALSE(bits[0]);
+    EXPECT_TRUE(bits[1]);
+    EXPECT_TRUE(bits[2]);
+    bits.PopBack();
+    EXPECT_EQ(bits.Size(), kOddBits - 1);
+}
+
+// Биты за пределами Size() остаются нулевыми после Flip, Resize и PopBack
+TEST(BitVector, TailBitsStayClear) {
+    BitVector<> bits(kOddBits, true);
+    EXPECT_EQ(bits.Count(), kOddBits);
+    bits.Flip();
+    EXPECT_EQ(bits.Count(), 0u);
+    EXPECT_EQ(bits.Count(false), kOddBits);
+    bits.Flip();
+    bits.Resize(70);
+    EXPECT_EQ(bits.Words().back() >> 6, 0u);
+    bits.Resize(kOddBits);
+    EXPECT_EQ(bits.Count(), 70u);
+    EXPECT_EQ(bits.Find(false), 70u);
+    EXPECT_EQ(bits.Find(true, 70), kOddBits);
+    bits.Fill(false);
+    EXPECT_EQ(bits.Find(true), kOddBits);
+}
+
+// Аллокатор, который отказывает в блоках больше max_words слов
+template <typename T>
+struct LimitedAllocator {
+    using value_type = T;
+
+    static inline size_t max_words = 0;
+
+    LimitedAllocator() = default;
+
+    template <typename U>
+    LimitedAllocator(const LimitedAllocator<U>&) noexcept {
+    }
+
+    T* allocate(size_t n) {
+        if (n > max_words) {
+            throw std::bad_alloc();
+        }
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    friend bool operator==(const LimitedAllocator&, const LimitedAllocator&) = default;
+};
+
+// Неудачный рост Resize(n, true) не портит хвост последнего слова
+TEST(BitVector, FailedResizeKeepsTailClear) {
+    LimitedAllocator<uint64_t>::max_words = 1;
+    BitVector<LimitedAllocator<uint64_t>> bits(10, false);
+    EXPECT_THROW(bits.Resize(200, true), std::bad_alloc);
+    EXPECT_EQ(bits.Size(), 10u);
+    EXPECT_EQ(bits.Count(), 0u);
+    EXPECT_EQ(bits.Find(true), 10u);
+    EXPECT_EQ(bits.Words().back(), 0u);
+}
+
+TEST(BitVector, EmptyVector) {
+    BitVector<> bits;
+    EXPECT_EQ(bits.Count(), 0u);
+    EXPECT_EQ(bits.Find(true), 0u);
+    EXPECT_EQ(bits.begin(), bits.end());
+    bits.Flip();
+    bits.ShrinkToFit();
+    EXPECT_EQ(bits.Size(), 0u);
+}
+
+TEST(BitVector, MatchesStdVectorBool) {
+    std::mt19937 rng(3);
+    BitVector<> lhs;
+    BitVector<> rhs;
+    std::vector<bool> ref_lhs;
+    std::vector<bool> ref_rhs;
+    for (size_t i = 0; i < 2000 + 17; ++i) {
+        const bool a = rng() % 2 != 0;
+        const bool b = rng() % 5 == 0;
+        lhs.PushBack(a);
+        rhs.PushBack(b);
+        ref_lhs.push_back(a);
+        ref_rhs.push_back(b);
+    }
+    const BitVector<> both = lhs & rhs;
+    const BitVector<> any = lhs | rhs;
+    const BitVector<> diff = lhs ^ rhs;
+    BitVector<> only = lhs;
+    only.AndNot(rhs);
+    for (size_t i = 0; i < ref_lhs.size(); ++i) {
+        ASSERT_EQ(both[i], ref_lhs[i] && ref_rhs[i]);
+        ASSERT_EQ(any[i], ref_lhs[i] || ref_rhs[i]);
+        ASSERT_EQ(diff[i], ref_lhs[i] != ref_rhs[i]);
+        ASSERT_EQ(only[i], ref_lhs[i] && !ref_rhs[i]);
+    }
+    EXPECT_EQ(lhs.Count(), static_cast<size_t>(std::count(ref_lhs.begin(), ref_lhs.end(), true)));
+    EXPECT_TRUE(std::ranges::equal(std::as_const(lhs), ref_lhs));
+    const auto first_rhs = std::find(ref_rhs.begin(), ref_rhs.end(), true);
+    EXPECT_EQ(rhs.Find(true), static_cast<size_t>(first_rhs - ref_rhs.begin()));
+    BitVector<> copy = lhs;
+    EXPECT_TRUE(copy == lhs);
+    copy[5].Flip();
+    EXPECT_FALSE(copy == lhs);
+}
+
+}  // namespace
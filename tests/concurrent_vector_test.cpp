@@ -0,0 +1,101 @@
+#include "concurrent_vector.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Элемент, конструктор которого бросает исключение для отрицательных значений
+struct Checked {
+    explicit Checked(int value)
+        : value(value) {
+        if (value < 0) {
+            throw std::invalid_argument("negative");
+        }
+    }
+
+    int value;
+};
+
+TEST(ConcurrentVector, PushBackKeepsReferencesStable) {
+    ConcurrentVector<std::string> v;
+    const std::string& first = v.PushBack("first");
+    for (int i = 1; i < 1000; ++i) {
+        v.EmplaceBack(std::to_string(i));
+    }
+    EXPECT_EQ(&first, &v[0]);
+    EXPECT_EQ(first, "first");
+    ASSERT_EQ(v.Size(), 1000u);
+    EXPECT_EQ(v[999], "999");
+    EXPECT_GE(v.Capacity(), 1000u);
+}
+
+TEST(ConcurrentVector, ParallelPushBackPublishesEveryElement) {
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 5000;
+    ConcurrentVector<int> v;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&v, t] {
+            for (int i = 0; i < kPerThread; ++i) {
+                v.PushBack(t * kPerThread + i);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQ(v.Size(), static_cast<size_t>(kThreads * kPerThread));
+    std::vector<int> values;
+    v.ForEachPublished([&values](size_t index, const int& value) {
+        EXPECT_TRUE(index < static_cast<size_t>(kThreads * kPerThread));
+        values.push_back(value);
+    });
+    std::sort(values.begin(), values.end());
+    ASSERT_EQ(values.size(), static_cast<size_t>(kThreads * kPerThread));
+    for (int i = 0; i < kThreads * kPerThread; ++i) {
+        ASSERT_EQ(values[i], i);
+    }
+}
+
+// Индекс, конструктор элемента которого бросил исключение, остаётся неопубликованным
+TEST(ConcurrentVector, FailedConstructionLeavesGap) {
+    ConcurrentVector<Checked> v;
+    v.EmplaceBack(1);
+    EXPECT_THROW(v.EmplaceBack(-1), std::invalid_argument);
+    v.EmplaceBack(3);
+    EXPECT_EQ(v.Size(), 3u);
+    EXPECT_TRUE(v.IsPublished(0));
+    EXPECT_FALSE(v.IsPublished(1));
+    EXPECT_TRUE(v.IsPublished(2));
+    EXPECT_FALSE(v.IsPublished(3));
+    int published = 0;
+    v.ForEachPublished([&published](size_t, const Checked&) {
+        ++published;
+    });
+    EXPECT_EQ(published, 2);
+}
+
+TEST(ConcurrentVector, ReserveAndClearKeepSegments) {
+    ConcurrentVector<std::string> v;
+    v.Reserve(100);
+    const size_t capacity = v.Capacity();
+    EXPECT_GE(capacity, 100u);
+    for (int i = 0; i < 100; ++i) {
+        v.PushBack(std::to_string(i));
+    }
+    EXPECT_EQ(v.Capacity(), capacity);
+    v.Clear();
+    EXPECT_EQ(v.Size(), 0u);
+    EXPECT_FALSE(v.IsPublished(0));
+    EXPECT_EQ(v.Capacity(), capacity);
+    v.PushBack("again");
+    EXPECT_EQ(v[0], "again");
+}
+
+}  // namespace
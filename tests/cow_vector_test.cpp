@@ -0,0 +1,129 @@
+#include "cow_vector.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <functional>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+CowVector<std::string> MakeCow(int count) {
+    Vector<std::string> elements;
+    for (int i = 0; i < count; ++i) {
+        elements.PushBack(std::to_string(i));
+    }
+    return CowVector<std::string>(std::move(elements));
+}
+
+TEST(CowVector, CopySharesUntilFirstWrite) {
+    CowVector<std::string> original = MakeCow(10);
+    const CowVector<std::string> snapshot = original;
+    EXPECT_EQ(original.UseCount(), 2u);
+    EXPECT_EQ(original.View().data(), snapshot.View().data());
+    original[0] = "changed";
+    EXPECT_EQ(original.UseCount(), 1u);
+    EXPECT_EQ(snapshot.UseCount(), 1u);
+    EXPECT_EQ(snapshot[0], "0");
+    EXPECT_EQ(original[0], "changed");
+    EXPECT_FALSE(original == snapshot);
+    // Собственный блок больше не копируется: ссылки на элементы остаются прежними
+    original.Reserve(20);
+    const std::string* data = original.View().data();
+    original.PushBack("10");
+    original.Erase(original.begin() + 1);
+    EXPECT_EQ(original.Size(), 10u);
+    EXPECT_EQ(original[9], "10");
+    EXPECT_EQ(original.UseCount(), 1u);
+    EXPECT_EQ(original.View().data(), data);
+}
+
+// Аргумент EmplaceBack может ссылаться на элемент разделённого блока
+TEST(CowVector, EmplaceBackFromSharedElement) {
+    CowVector<std::string> v = MakeCow(3);
+    const CowVector<std::string> snapshot = v;
+    v.EmplaceBack(snapshot[2]);
+    v.PushBack(v[0]);
+    EXPECT_TRUE(std::ranges::equal(v, std::vector<std::string>{"0", "1", "2", "2", "0"}));
+    EXPECT_EQ(snapshot.Size(), 3u);
+}
+
+// Строка, при копировании которой сначала вызывается on_copy
+struct CopyHook {
+    static inline std::function<void()> on_copy;
+
+    explicit CopyHook(std::string value)
+        : value(std::move(value)) {
+    }
+
+    CopyHook(const CopyHook& other)
+        : value((on_copy ? on_copy() : void(), other.value)) {
+    }
+
+    CopyHook& operator=(const CopyHook&) = default;
+
+    std::string value;
+};
+
+// Последний снимок отпускает разделённый блок, пока PushBack копирует элемент из него:
+// блок должен дожить до конца построения
+TEST(CowVector, SharedBlockOutlivesPushBackArgument) {
+    Vector<CopyHook> elements;
+    elements.EmplaceBack(std::string(100, 'a'));
+    CowVector<CopyHook> v(std::move(elements));
+    std::optional<CowVector<CopyHook>> snapshot(v);
+    const CopyHook& shared = std::as_const(v)[0];
+    int copies = 0;
+    CopyHook::on_copy = [&] {
+        // Первая копия — отделение блока, вторая — новый элемент
+        if (++copies == 2) {
+            snapshot.reset();
+        }
+    };
+    v.PushBack(shared);
+    CopyHook::on_copy = nullptr;
+    ASSERT_EQ(v.Size(), 2u);
+    EXPECT_EQ(v[0].value, std::string(100, 'a'));
+    EXPECT_EQ(v[1].value, std::string(100, 'a'));
+    EXPECT_FALSE(snapshot.has_value());
+    EXPECT_EQ(v.UseCount(), 1u);
+}
+
+TEST(CowVector, EmptyAndClear) {
+    CowVector<int> empty;
+    EXPECT_EQ(empty.Size(), 0u);
+    EXPECT_EQ(empty.UseCount(), 0u);
+    EXPECT_EQ(empty.begin(), empty.end());
+    CowVector<std::string> v = MakeCow(5);
+    CowVector<std::string> copy = v;
+    v.Clear();
+    EXPECT_EQ(v.Size(), 0u);
+    EXPECT_EQ(copy.Size(), 5u);
+    EXPECT_EQ(copy.UseCount(), 1u);
+    copy.Clear();
+    EXPECT_EQ(copy.Size(), 0u);
+    EXPECT_EQ(copy.UseCount(), 1u);
+}
+
+TEST(CowVector, SnapshotsAreReadableFromOtherThreads) {
+    CowVector<std::string> v = MakeCow(1000);
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([snapshot = v] {
+            EXPECT_EQ(snapshot[999], "999");
+            EXPECT_EQ(std::count(snapshot.begin(), snapshot.end(), "500"), 1);
+        });
+    }
+    v.Mutable().Resize(10);
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(v.Size(), 10u);
+    EXPECT_EQ(v.UseCount(), 1u);
+}
+
+}  // namespace
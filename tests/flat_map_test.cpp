@@ -0,0 +1,140 @@
+#include "flat_map.h"
+
+#include <gtest/gtest.h>
+
+#include <initializer_list>
+#include <map>
+#include <random>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using Map = FlatMap<int, std::string>;
+
+template <typename T>
+Vector<T> MakeVector(std::initializer_list<T> values) {
+    Vector<T> result;
+    result.Append(values);
+    return result;
+}
+
+static_assert(std::ranges::random_access_range<Map>);
+static_assert(std::ranges::random_access_range<const Map>);
+static_assert(std::ranges::random_access_range<const FlatSet<int>>);
+
+TEST(FlatSet, SortsAndDeduplicates) {
+    FlatSet<int> set(MakeVector({5, 1, 3, 1, 5, 2}));
+    EXPECT_TRUE(std::ranges::equal(set, std::vector<int>{1, 2, 3, 5}));
+    EXPECT_TRUE(set.Contains(3));
+    EXPECT_FALSE(set.Contains(4));
+    EXPECT_EQ(*set.LowerBound(4), 5);
+    EXPECT_EQ(set.Find(4), set.end());
+}
+
+TEST(FlatSet, InsertEraseRoundTrip) {
+    FlatSet<int> set;
+    EXPECT_TRUE(set.Insert(2).second);
+    EXPECT_FALSE(set.Insert(2).second);
+    set.InsertRange(std::vector<int>{9, 4, 2, 7});
+    EXPECT_TRUE(std::ranges::equal(set, std::vector<int>{2, 4, 7, 9}));
+    EXPECT_EQ(set.Erase(4), 1u);
+    EXPECT_EQ(set.Erase(4), 0u);
+    EXPECT_EQ(*set.Erase(set.begin()), 7);
+    const Vector<int> keys = set.Extract();
+    EXPECT_EQ(keys, MakeVector({7, 9}));
+    EXPECT_EQ(set.Size(), 0u);
+}
+
+TEST(FlatMap, KeepsFirstOfEqualKeys) {
+    const Map map(MakeVector({3, 1, 3}), MakeVector<std::string>({"a", "b", "c"}));
+    ASSERT_EQ(map.Size(), 2u);
+    EXPECT_EQ(map.Find(3)->second, "a");
+    EXPECT_EQ((*map.Find(1)).second, "b");
+}
+
+TEST(FlatMap, RejectsMismatchedContainers) {
+    EXPECT_THROW(Map(MakeVector({3, 1, 2}), MakeVector<std::string>({"c", "a"})), std::invalid_argument);
+    EXPECT_THROW(Map(sorted_unique, MakeVector({1}), MakeVector<std::string>({"a", "b"})), std::invalid_argument);
+}
+
+TEST(FlatMap, ReferenceWritesValue) {
+    Map map;
+    map[2] = "two";
+    map.TryEmplace(1, "one");
+    for (auto [key, value] : map) {
+        value += "!";
+    }
+    EXPECT_EQ(map[1], "one!");
+    EXPECT_EQ(map[2], "two!");
+    map.begin()->second = "uno";
+    EXPECT_EQ(map.Values()[0], "uno");
+}
+
+TEST(FlatMap, ConstRangeAlgorithms) {
+    Map map;
+    for (int i = 0; i < 20; ++i) {
+        map.InsertOrAssign(i, std::to_string(i * i));
+    }
+    EXPECT_EQ(std::ranges::count_if(std::as_const(map), [](const auto& pair) {
+                  return pair.first % 2 == 0;
+              }),
+              10);
+    const auto it = std::ranges::find_if(std::as_const(map), [](const auto& pair) {
+        return pair.second == "49";
+    });
+    ASSERT_NE(it, map.cend());
+    const Map::value_type copy = *it;
+    EXPECT_EQ(copy.first, 7);
+}
+
+// Случайные вставки и удаления сверяются с std::map, в том числе с индексом Эйтцингера
+template <typename Lookup>
+void CheckMatchesStdMap() {
+    std::mt19937 rng(7);
+    FlatMap<int, int, std::less<int>, Lookup> map;
+    std::map<int, int> ref;
+    for (int step = 0; step < 3000; ++step) {
+        const int key = static_cast<int>(rng() % 200);
+        switch (rng() % 4) {
+            case 0:
+                map.InsertOrAssign(key, step);
+                ref.insert_or_assign(key, step);
+                break;
+            case 1:
+                EXPECT_EQ(map.Erase(key), ref.erase(key));
+                break;
+            case 2:
+                map.InsertRange(std::vector<std::pair<int, int>>{{key, step}, {key + 1, step}});
+                ref.insert({key, step});
+                ref.insert({key + 1, step});
+                break;
+            case 3: {
+                const auto it = map.Find(key);
+                const auto ref_it = ref.find(key);
+                ASSERT_EQ(it == map.end(), ref_it == ref.end());
+                if (ref_it != ref.end()) {
+                    EXPECT_EQ(it->second, ref_it->second);
+                }
+                break;
+            }
+        }
+        ASSERT_EQ(map.Size(), ref.size());
+    }
+    EXPECT_TRUE(std::ranges::equal(map, ref, [](const auto& lhs, const auto& rhs) {
+        return lhs.first == rhs.first && lhs.second == rhs.second;
+    }));
+}
+
+TEST(FlatMap, MatchesStdMap) {
+    CheckMatchesStdMap<BranchlessLookup>();
+}
+
+TEST(FlatMap, MatchesStdMapWithEytzingerLookup) {
+    CheckMatchesStdMap<EytzingerLookup>();
+}
+
+}  // namespace
@@ -0,0 +1,94 @@
+#include "huge_page_allocator.h"
+
+#include "vector.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <numeric>
+#include <system_error>
+
+#include <sys/mman.h>
+
+namespace {
+
+constexpr size_t kSmallThreshold = size_t{64} << 10;
+
+bool IsHugePageAligned(const void* p) {
+    return reinterpret_cast<uintptr_t>(p) % HugePageAllocator<int>::kHugePageSize == 0;
+}
+
+TEST(HugePageAllocator, SmallBlocksComeFromHeap) {
+    HugePageAllocator<int> alloc;
+    const auto result = alloc.allocate_at_least(100);
+    EXPECT_EQ(result.count, 100u);
+    alloc.deallocate(result.ptr, result.count);
+}
+
+// Блок от порога выделяется через mmap с границы большой страницы и отдаётся целиком
+TEST(HugePageAllocator, LargeBlocksAreRoundedToHugePages) {
+    HugePageAllocator<int> alloc({.threshold_bytes = kSmallThreshold});
+    const auto result = alloc.allocate_at_least(kSmallThreshold / sizeof(int));
+    EXPECT_TRUE(IsHugePageAligned(result.ptr));
+    EXPECT_EQ(result.count * sizeof(int), HugePageAllocator<int>::kHugePageSize);
+    result.ptr[result.count - 1] = 1;
+    alloc.deallocate(result.ptr, result.count);
+}
+
+// Рост вектора пересекает порог и продолжается через mremap, сохраняя элементы
+TEST(HugePageAllocator, VectorGrowthKeepsElements) {
+    for (const HugePageMode mode : {HugePageMode::kNone, HugePageMode::kTransparent, HugePageMode::kExplicit}) {
+        const HugePageAllocator<int> alloc({.threshold_bytes = kSmallThreshold, .mode = mode, .first_touch = true});
+        Vector<int, HugePageAllocator<int>> v(alloc);
+        constexpr int kCount = 3 << 20;
+        for (int i = 0; i < kCount; ++i) {
+            v.PushBack(i);
+        }
+        ASSERT_EQ(v.Size(), static_cast<size_t>(kCount));
+        EXPECT_TRUE(IsHugePageAligned(v.Data()));
+        EXPECT_EQ(std::accumulate(v.begin(), v.end(), int64_t{0}), int64_t{kCount} * (kCount - 1) / 2);
+        EXPECT_EQ(v.GetAllocator().GetOptions().threshold_bytes, kSmallThreshold);
+        v.ShrinkToFit();
+        EXPECT_EQ(v[kCount - 1], kCount - 1);
+    }
+}
+
+// Отображение, за которым адреса заняты, переезжает и остаётся выровненным по большой странице
+TEST(HugePageAllocator, MovedMappingStaysAligned) {
+    constexpr size_t kPage = HugePageAllocator<int>::kHugePageSize;
+    HugePageAllocator<int> alloc({.threshold_bytes = kSmallThreshold});
+    const auto result = alloc.allocate_at_least(kPage / sizeof(int));
+    ASSERT_EQ(result.count * sizeof(int), kPage);
+    std::iota(result.ptr, result.ptr + result.count, 0);
+    void* blocker = ::mmap(reinterpret_cast<std::byte*>(result.ptr) + kPage, 4096, PROT_NONE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    ASSERT_NE(blocker, MAP_FAILED);
+    const size_t new_count = 2 * result.count;
+    int* moved = alloc.reallocate(result.ptr, result.count, new_count);
+    EXPECT_NE(moved, result.ptr);
+    EXPECT_TRUE(IsHugePageAligned(moved));
+    EXPECT_EQ(moved[0], 0);
+    EXPECT_EQ(moved[result.count - 1], static_cast<int>(result.count - 1));
+    moved[new_count - 1] = 1;
+    alloc.deallocate(moved, new_count);
+    ::munmap(blocker, 4096);
+}
+
+TEST(HugePageAllocator, RejectsOutOfRangeNumaNode) {
+    HugePageAllocator<int> alloc({.threshold_bytes = kSmallThreshold, .numa_node = 1 << 20});
+    EXPECT_THROW(alloc.allocate(kSmallThreshold), std::system_error);
+}
+
+// Ошибка настроек при росте через reallocate обнаруживается до mremap: блок остаётся на месте
+TEST(HugePageAllocator, FailedReallocateKeepsBlock) {
+    HugePageAllocator<int> alloc({.threshold_bytes = kSmallThreshold});
+    const auto result = alloc.allocate_at_least(kSmallThreshold / sizeof(int));
+    std::iota(result.ptr, result.ptr + result.count, 0);
+    HugePageAllocator<int> bad_node({.threshold_bytes = kSmallThreshold, .numa_node = 1 << 20});
+    ASSERT_TRUE(bad_node == alloc);
+    EXPECT_THROW(bad_node.reallocate(result.ptr, result.count, 2 * result.count), std::system_error);
+    EXPECT_EQ(result.ptr[result.count - 1], static_cast<int>(result.count - 1));
+    alloc.deallocate(result.ptr, result.count);
+}
+
+}  // namespace
@@ -0,0 +1,108 @@
+#include "mapped_vector.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <concepts>
+#include <filesystem>
+#include <numeric>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <unistd.h>
+
+namespace {
+
+// Временный файл, удаляемый по завершении теста
+class TempFile {
+public:
+    explicit TempFile(const std::string& name)
+        : path_(std::filesystem::temp_directory_path() / (name + "." + std::to_string(::getpid()))) {
+        std::filesystem::remove(path_);
+    }
+
+    ~TempFile() {
+        std::filesystem::remove(path_);
+    }
+
+    const std::filesystem::path& Path() const noexcept {
+        return path_;
+    }
+
+private:
+    std::filesystem::path path_;
+};
+
+// Вектор только для чтения не объявляет изменяющих методов
+template <typename V>
+concept HasMutators = requires(V& v) {
+    v.PushBack(1);
+    v.EmplaceBack(1);
+    v.PopBack();
+    v.Resize(1);
+    v.Reserve(1);
+    v.Clear();
+    { v[0] } -> std::same_as<int&>;
+};
+
+static_assert(HasMutators<MappedVector<int>>);
+static_assert(!HasMutators<ReadOnlyMappedVector<int>>);
+static_assert(std::same_as<decltype(*std::declval<ReadOnlyMappedVector<int>&>().begin()), const int&>);
+
+TEST(MappedVector, ReopenRoundTrip) {
+    TempFile file("mapped_vector_round_trip");
+    {
+        MappedVector<int> v(file.Path());
+        EXPECT_EQ(v.Size(), 0u);
+        for (int i = 0; i < 10000; ++i) {
+            v.PushBack(i);
+        }
+        v.EmplaceBack(v[0]);
+        v.PopBack();
+        v.Flush();
+    }
+    // При закрытии файл обрезается до Size() элементов
+    EXPECT_EQ(std::filesystem::file_size(file.Path()), 10000 * sizeof(int));
+    MappedVector<int> v(file.Path());
+    ASSERT_EQ(v.Size(), 10000u);
+    EXPECT_EQ(v.Capacity(), 10000u);
+    EXPECT_EQ(std::accumulate(v.cbegin(), v.cend(), 0LL), 9999LL * 10000 / 2);
+    v.Resize(5);
+    v.Resize(8);
+    EXPECT_EQ(v[4], 4);
+    EXPECT_EQ(v[7], 0);
+}
+
+// Неконстантный вектор только для чтения обходится range-for и алгоритмами
+TEST(MappedVector, ReadOnlyGivesConstAccess) {
+    TempFile file("mapped_vector_read_only");
+    {
+        MappedVector<int> v(file.Path());
+        v.Resize(16);
+        std::iota(v.begin(), v.end(), 0);
+    }
+    ReadOnlyMappedVector<int> v(file.Path());
+    ASSERT_EQ(v.Size(), 16u);
+    EXPECT_EQ(v[15], 15);
+    int expected = 0;
+    for (const int& value : v) {
+        EXPECT_EQ(value, expected++);
+    }
+    EXPECT_EQ(std::accumulate(v.begin(), v.end(), 0), 15 * 16 / 2);
+    v.Advise(MappedAccess::kSequential);
+    v.Flush();
+    ReadOnlyMappedVector<int> moved(std::move(v));
+    EXPECT_EQ(moved.Size(), 16u);
+}
+
+TEST(MappedVector, RejectsTruncatedFile) {
+    TempFile file("mapped_vector_truncated");
+    {
+        MappedVector<char> bytes(file.Path());
+        bytes.Resize(7);
+    }
+    EXPECT_THROW(ReadOnlyMappedVector<int>(file.Path()), std::system_error);
+}
+
+}  // namespace
@@ -0,0 +1,79 @@
+#include "pool_allocator.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+
+namespace {
+
+TEST(VectorPool, ClassIndexRoundsUpToPowerOfTwo) {
+    EXPECT_EQ(vector_pool::ClassIndex(1), 0u);
+    EXPECT_EQ(vector_pool::ClassIndex(64), 0u);
+    EXPECT_EQ(vector_pool::ClassIndex(65), 1u);
+    EXPECT_EQ(vector_pool::ClassIndex(128), 1u);
+    EXPECT_EQ(vector_pool::ClassIndex(vector_pool::kMaxClassSize), vector_pool::kClassCount - 1);
+    EXPECT_EQ(vector_pool::ClassSize(vector_pool::kClassCount - 1), vector_pool::kMaxClassSize);
+}
+
+// Вместимость вектора сразу дорастает до размера блока класса
+TEST(PoolAllocator, CapacityFillsWholeBlock) {
+    PooledVector<int> v;
+    v.Reserve(10);
+    EXPECT_EQ(v.Capacity(), vector_pool::kMinClassSize / sizeof(int));
+    for (int i = 0; i < 1000; ++i) {
+        v.PushBack(i);
+    }
+    EXPECT_EQ(v.Capacity() * sizeof(int), 4096u);
+    EXPECT_EQ(v[999], 999);
+}
+
+TEST(PoolAllocator, FreedBlockIsReusedByTheSameThread) {
+    PoolAllocator<int>::Trim();
+    PoolAllocator<int> alloc;
+    int* first = alloc.allocate(100);
+    alloc.deallocate(first, 100);
+    int* second = alloc.allocate(120);
+    EXPECT_EQ(second, first);
+    alloc.deallocate(second, 120);
+    // Блоки больше самого крупного класса в пул не попадают
+    const size_t huge = vector_pool::kMaxClassSize / sizeof(int) + 1;
+    int* big = alloc.allocate(huge);
+    alloc.deallocate(big, huge);
+    PoolAllocator<int>::Trim();
+    EXPECT_EQ(vector_pool::Depot::Instance().Bytes(), 0u);
+}
+
+// Кеш завершившегося потока уходит в хранилище, откуда блоки забирает другой поток
+TEST(PoolAllocator, ThreadExitFlushesCacheToDepot) {
+    PoolAllocator<char>::Trim();
+    void* freed = nullptr;
+    std::thread([&freed] {
+        PooledVector<std::string> names;
+        for (int i = 0; i < 100; ++i) {
+            names.PushBack(std::to_string(i));
+        }
+        freed = names.Data();
+    }).join();
+    EXPECT_GT(vector_pool::Depot::Instance().Bytes(), 0u);
+    PooledVector<std::string> reused;
+    reused.Reserve(100);
+    EXPECT_EQ(static_cast<void*>(reused.Data()), freed);
+    PoolAllocator<char>::Trim();
+}
+
+TEST(PoolAllocator, VectorMovesAcrossThreads) {
+    PooledVector<std::string> v;
+    std::thread([&v] {
+        for (int i = 0; i < 50; ++i) {
+            v.PushBack(std::to_string(i));
+        }
+    }).join();
+    PooledVector<std::string> copy = v;
+    v = PooledVector<std::string>();
+    ASSERT_EQ(copy.Size(), 50u);
+    EXPECT_EQ(copy[49], "49");
+    PoolAllocator<char>::Trim();
+}
+
+}  // namespace
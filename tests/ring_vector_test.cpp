@@ -0,0 +1,195 @@
+#include "ring_vector.h"
+
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <memory_resource>
+#include <random>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+static_assert(std::ranges::random_access_range<RingVector<int>>);
+static_assert(std::ranges::random_access_range<const RingVector<std::string>>);
+
+// Элемент с бросающим перемещением: при переносе он копируется, и копия может бросить исключение
+struct ThrowingCopy {
+    static inline int copies_left = -1;
+
+    explicit ThrowingCopy(int value)
+        : value(value) {
+    }
+
+    ThrowingCopy(const ThrowingCopy& other)
+        : value(other.value) {
+        if (copies_left == 0) {
+            throw std::runtime_error("copy");
+        }
+        --copies_left;
+    }
+
+    ThrowingCopy(ThrowingCopy&& other) noexcept(false)
+        : value(other.value) {
+    }
+
+    int value;
+};
+
+// Ресурс памяти, который считает неосвобождённые байты и передаёт запросы дальше
+class CountingResource : public std::pmr::memory_resource {
+public:
+    size_t outstanding = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        outstanding += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        outstanding -= bytes;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+// Очередь, заполненная так, что элементы переходят через конец буфера
+RingVector<std::string> MakeWrapped() {
+    RingVector<std::string> ring;
+    ring.Reserve(8);
+    for (int i = 0; i < 8; ++i) {
+        ring.PushBack(std::to_string(i));
+    }
+    for (int i = 0; i < 5; ++i) {
+        ring.PopFront();
+    }
+    for (int i = 8; i < 12; ++i) {
+        ring.PushBack(std::to_string(i));
+    }
+    return ring;
+}
+
+TEST(RingVector, WrapAroundKeepsOrder) {
+    const RingVector<std::string> ring = MakeWrapped();
+    ASSERT_EQ(ring.Capacity(), 8u);
+    EXPECT_FALSE(ring.SecondSegment().empty());
+    EXPECT_TRUE(std::ranges::equal(ring, std::vector<std::string>{"5", "6", "7", "8", "9", "10", "11"}));
+    EXPECT_EQ(ring.Front(), "5");
+    EXPECT_EQ(ring.Back(), "11");
+}
+
+TEST(RingVector, ReserveAndLinearizeJoinSegments) {
+    RingVector<std::string> ring = MakeWrapped();
+    RingVector<std::string> other = MakeWrapped();
+    ring.Reserve(100);
+    EXPECT_TRUE(ring.SecondSegment().empty());
+    EXPECT_TRUE(std::ranges::equal(ring, other));
+    const auto joined = other.Linearize();
+    EXPECT_EQ(other.Capacity(), 8u);
+    EXPECT_TRUE(std::ranges::equal(joined, ring));
+    const RingVector<std::string> copy = ring;
+    EXPECT_TRUE(std::ranges::equal(copy, ring));
+}
+
+TEST(RingVector, GrowthFromBothEnds) {
+    RingVector<std::string> ring = MakeWrapped();
+    ring.PushFront("4");
+    ring.EmplaceBack(ring.Front());
+    ring.EmplaceFront(ring.Back());
+    EXPECT_TRUE(std::ranges::equal(ring, std::vector<std::string>{"4", "4", "5", "6", "7", "8", "9", "10", "11", "4"}));
+}
+
+// Если копирование второго куска бросит исключение, очередь остаётся прежней
+TEST(RingVector, FailedRelocationKeepsElements) {
+    RingVector<ThrowingCopy> ring;
+    ring.Reserve(4);
+    for (int i = 0; i < 4; ++i) {
+        ring.EmplaceBack(i);
+    }
+    ring.PopFront();
+    ring.PopFront();
+    ring.EmplaceBack(4);
+    ring.EmplaceBack(5);
+    ASSERT_FALSE(ring.SecondSegment().empty());
+    ThrowingCopy::copies_left = 3;
+    EXPECT_THROW(ring.Reserve(16), std::runtime_error);
+    ThrowingCopy::copies_left = -1;
+    EXPECT_EQ(ring.Capacity(), 4u);
+    std::vector<int> values;
+    for (const ThrowingCopy& element : ring) {
+        values.push_back(element.value);
+    }
+    EXPECT_EQ(values, (std::vector<int>{2, 3, 4, 5}));
+}
+
+// Аллокаторы не распространяются при перемещении и не равны: буфер rhs забрать нельзя,
+// и элементы переезжают в память своего ресурса
+TEST(RingVector, MoveAssignmentBetweenUnequalAllocators) {
+    using PmrRing = RingVector<std::string, std::pmr::polymorphic_allocator<std::string>>;
+    CountingResource lhs_resource;
+    CountingResource rhs_resource;
+    {
+        PmrRing lhs(&lhs_resource);
+        PmrRing rhs(&rhs_resource);
+        lhs.PushBack("old");
+        rhs.Reserve(4);
+        for (int i = 0; i < 6; ++i) {
+            rhs.PushBack(std::to_string(i));
+            if (i % 2 == 0) {
+                rhs.PopFront();
+            }
+        }
+        lhs = std::move(rhs);
+        EXPECT_EQ(lhs.GetAllocator().resource(), &lhs_resource);
+        EXPECT_TRUE(std::ranges::equal(lhs, std::vector<std::string>{"3", "4", "5"}));
+        EXPECT_EQ(rhs.Size(), 0u);
+
+        PmrRing small(&rhs_resource);
+        small.PushBack("small");
+        lhs = std::move(small);
+        EXPECT_TRUE(std::ranges::equal(lhs, std::vector<std::string>{"small"}));
+        EXPECT_EQ(lhs.GetAllocator().resource(), &lhs_resource);
+    }
+    EXPECT_EQ(lhs_resource.outstanding, 0u);
+    EXPECT_EQ(rhs_resource.outstanding, 0u);
+}
+
+TEST(RingVector, MatchesStdDeque) {
+    std::mt19937 rng(11);
+    RingVector<int> ring;
+    std::deque<int> ref;
+    for (int step = 0; step < 5000; ++step) {
+        switch (rng() % 4) {
+            case 0:
+                ring.PushBack(step);
+                ref.push_back(step);
+                break;
+            case 1:
+                ring.PushFront(step);
+                ref.push_front(step);
+                break;
+            case 2:
+                if (!ref.empty()) {
+                    ring.PopFront();
+                    ref.pop_front();
+                }
+                break;
+            case 3:
+                if (!ref.empty()) {
+                    ring.PopBack();
+                    ref.pop_back();
+                }
+                break;
+        }
+        ASSERT_EQ(ring.Size(), ref.size());
+    }
+    EXPECT_TRUE(std::ranges::equal(ring, ref));
+}
+
+}  // namespace
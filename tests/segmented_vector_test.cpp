@@ -0,0 +1,90 @@
+#include "segmented_vector.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory_resource>
+#include <mutex>
+#include <numeric>
+#include <ranges>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+using Small = SegmentedVector<std::string, std::allocator<std::string>, 4>;
+
+static_assert(std::ranges::random_access_range<Small>);
+static_assert(std::ranges::random_access_range<const Small>);
+// Перемещающее присваивание не бросает исключений, только если аллокатор распространяется или всегда равен
+static_assert(std::is_nothrow_move_assignable_v<Small>);
+static_assert(!std::is_nothrow_move_assignable_v<SegmentedVector<int, std::pmr::polymorphic_allocator<int>>>);
+
+TEST(SegmentedVector, GrowthKeepsAddressesAndIterators) {
+    Small v;
+    const std::string& first = v.EmplaceBack("first");
+    const auto it = v.begin();
+    for (int i = 1; i < 100; ++i) {
+        v.PushBack(std::to_string(i));
+    }
+    v.EmplaceBack(v[0]);
+    EXPECT_EQ(&first, &v[0]);
+    EXPECT_EQ(*it, "first");
+    ASSERT_EQ(v.Size(), 101u);
+    EXPECT_EQ(v.Capacity(), 104u);
+    EXPECT_EQ(v[100], "first");
+    EXPECT_EQ(v.end() - v.begin(), 101);
+}
+
+// Неперемещаемый тип: элементы строятся на месте и никогда не переезжают
+TEST(SegmentedVector, HoldsImmovableElements) {
+    SegmentedVector<std::mutex, std::allocator<std::mutex>, 2> locks;
+    for (int i = 0; i < 5; ++i) {
+        locks.EmplaceBack();
+    }
+    std::lock_guard guard(locks[4]);
+    EXPECT_EQ(locks.Size(), 5u);
+}
+
+TEST(SegmentedVector, ForEachSegmentCoversEveryElement) {
+    SegmentedVector<int, std::allocator<int>, 8> v;
+    for (int i = 0; i < 21; ++i) {
+        v.PushBack(i);
+    }
+    std::vector<size_t> sizes;
+    int sum = 0;
+    std::as_const(v).ForEachSegment([&](std::span<const int> segment) {
+        sizes.push_back(segment.size());
+        sum = std::accumulate(segment.begin(), segment.end(), sum);
+    });
+    EXPECT_EQ(sizes, (std::vector<size_t>{8, 8, 5}));
+    EXPECT_EQ(sum, 210);
+}
+
+TEST(SegmentedVector, CopyMovePopShrinkRoundTrip) {
+    Small v;
+    for (int i = 0; i < 10; ++i) {
+        v.PushBack(std::to_string(i));
+    }
+    Small copy = v;
+    EXPECT_TRUE(std::ranges::equal(copy, v));
+    for (int i = 0; i < 7; ++i) {
+        v.PopBack();
+    }
+    v.ShrinkToFit();
+    EXPECT_EQ(v.Capacity(), 4u);
+    EXPECT_TRUE(std::ranges::equal(v, std::vector<std::string>{"0", "1", "2"}));
+    Small moved = std::move(copy);
+    EXPECT_EQ(copy.Size(), 0u);
+    ASSERT_EQ(moved.Size(), 10u);
+    moved.Swap(v);
+    EXPECT_EQ(moved.Size(), 3u);
+    EXPECT_EQ(v[9], "9");
+    v.Clear();
+    EXPECT_EQ(v.Size(), 0u);
+    EXPECT_EQ(v.Capacity(), 12u);
+}
+
+}  // namespace
@@ -0,0 +1,97 @@
+#include "soa_vector.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <ranges>
+#include <string>
+#include <utility>
+
+namespace {
+
+using Soa = SoaVector<int, double, std::string>;
+
+static_assert(std::ranges::random_access_range<Soa>);
+static_assert(std::ranges::random_access_range<const Soa>);
+
+Soa MakeSoa(int count) {
+    Soa soa;
+    for (int i = 0; i < count; ++i) {
+        soa.EmplaceBack(i, i * 0.5, std::to_string(i));
+    }
+    return soa;
+}
+
+TEST(SoaVector, EmplaceBackAndFields) {
+    const Soa soa = MakeSoa(100);
+    ASSERT_EQ(soa.Size(), 100u);
+    EXPECT_EQ(soa.Get<0>(42), 42);
+    EXPECT_EQ(soa.Get<1>(42), 21.0);
+    EXPECT_EQ(soa.Get<2>(42), "42");
+    EXPECT_EQ(soa[7], std::make_tuple(7, 3.5, std::string("7")));
+}
+
+TEST(SoaVector, ColumnsAreCacheLineAligned) {
+    Soa soa = MakeSoa(10);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(soa.Column<0>().data()) % kCacheLineSize, 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(soa.Column<1>().data()) % kCacheLineSize, 0u);
+    EXPECT_EQ(soa.Column<1>().size(), 10u);
+}
+
+TEST(SoaVector, ReferenceWritesThroughToFields) {
+    Soa soa = MakeSoa(3);
+    auto [id, weight, name] = soa[1];
+    id = 10;
+    name = "ten";
+    soa[2] = std::make_tuple(20, 2.0, std::string("twenty"));
+    EXPECT_EQ(soa.Get<0>(1), 10);
+    EXPECT_EQ(soa.Get<2>(1), "ten");
+    EXPECT_EQ(soa[2], std::make_tuple(20, 2.0, std::string("twenty")));
+}
+
+TEST(SoaVector, ConstRangeAlgorithms) {
+    const Soa soa = MakeSoa(50);
+    EXPECT_EQ(std::ranges::count_if(soa, [](const auto& element) {
+                  return std::get<0>(element) % 5 == 0;
+              }),
+              10);
+    const auto it = std::ranges::find_if(std::as_const(soa), [](const auto& element) {
+        return std::get<2>(element) == "17";
+    });
+    EXPECT_EQ(it - soa.begin(), 17);
+    const Soa::value_type copy = *it;
+    EXPECT_EQ(std::get<1>(copy), 8.5);
+}
+
+TEST(SoaVector, EmplaceBackFromOwnElementWhileGrowing) {
+    SoaVector<std::string, int> soa;
+    soa.EmplaceBack(std::string(50, 'x'), 1);
+    while (soa.Size() < soa.Capacity()) {
+        soa.EmplaceBack("y", 2);
+    }
+    soa.EmplaceBack(soa.Get<0>(0), soa.Get<1>(0));
+    EXPECT_EQ(soa.Get<0>(soa.Size() - 1), std::string(50, 'x'));
+    EXPECT_EQ(soa.Get<1>(soa.Size() - 1), 1);
+}
+
+TEST(SoaVector, CopyMoveEraseRoundTrip) {
+    Soa soa = MakeSoa(20);
+    soa.Reserve(100);
+    Soa copy = soa;
+    EXPECT_TRUE(std::ranges::equal(copy, soa));
+    soa.Erase(soa.begin() + 2, soa.begin() + 5);
+    soa.Erase(soa.begin());
+    soa.PopBack();
+    ASSERT_EQ(soa.Size(), 15u);
+    EXPECT_EQ(soa.Get<2>(0), "1");
+    EXPECT_EQ(soa.Get<2>(1), "5");
+    Soa moved = std::move(copy);
+    EXPECT_EQ(copy.Size(), 0u);
+    EXPECT_EQ(moved.Size(), 20u);
+    moved.Swap(soa);
+    EXPECT_EQ(moved.Size(), 15u);
+    EXPECT_EQ(soa.Get<2>(19), "19");
+}
+
+}  // namespace
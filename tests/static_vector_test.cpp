@@ -0,0 +1,87 @@
+#include "static_vector.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <new>
+#include <string>
+#include <utility>
+
+namespace {
+
+// Вектор растёт, перевыделяет и освобождает память во время вычисления на этапе компиляции
+constexpr int ConstexprSum(int n) {
+    Vector<int> v;
+    for (int i = 1; i <= n; ++i) {
+        v.PushBack(i);
+    }
+    v.Insert(v.begin(), 100);
+    v.Erase(v.begin());
+    Vector<int> copy = v;
+    v.ShrinkToFit();
+    int sum = 0;
+    for (const int value : copy) {
+        sum += value;
+    }
+    return sum;
+}
+
+static_assert(ConstexprSum(100) == 5050);
+
+// Перенос нетривиального типа при росте и возврат элементов во встроенный буфер
+constexpr std::array<size_t, 3> ConstexprStrings() {
+    SmallVector<std::string, 2> v;
+    v.PushBack("a");
+    v.PushBack(std::string(40, 'b'));
+    v.PushBack(v[0]);
+    v.PopBack();
+    v.ShrinkToFit();
+    return {v.Size(), v[1].size(), v.Capacity()};
+}
+
+static_assert(ConstexprStrings() == std::array<size_t, 3>{2, 40, 2});
+
+constexpr size_t ConstexprStatic() {
+    StaticVector<int, 8> v;
+    v.Resize(5);
+    v.PushBack(7);
+    return v.Size() + static_cast<size_t>(v[5]);
+}
+
+static_assert(ConstexprStatic() == 13);
+
+TEST(StaticVector, OverflowThrowsAndKeepsElements) {
+    StaticVector<std::string, 3> v;
+    v.PushBack("a");
+    v.PushBack("b");
+    v.PushBack("c");
+    EXPECT_EQ(v.Capacity(), 3u);
+    EXPECT_THROW(v.PushBack("d"), std::bad_alloc);
+    EXPECT_THROW(v.Reserve(4), std::bad_alloc);
+    EXPECT_THROW(v.Insert(v.begin(), "x"), std::bad_alloc);
+    EXPECT_THROW(v.Resize(10), std::bad_alloc);
+    ASSERT_EQ(v.Size(), 3u);
+    EXPECT_EQ(v[0], "a");
+    EXPECT_EQ(v[2], "c");
+}
+
+TEST(StaticVector, CopyMoveSwapStayInline) {
+    StaticVector<std::string, 4> v;
+    v.PushBack("one");
+    v.PushBack("two");
+    StaticVector<std::string, 4> copy = v;
+    StaticVector<std::string, 4> moved = std::move(v);
+    EXPECT_EQ(moved.Size(), 2u);
+    EXPECT_EQ(copy, moved);
+    copy.PushBack("three");
+    copy.Swap(moved);
+    EXPECT_EQ(moved.Size(), 3u);
+    EXPECT_EQ(copy.Size(), 2u);
+    EXPECT_EQ(moved[2], "three");
+    EXPECT_EQ(moved.Capacity(), 4u);
+    moved.Clear();
+    moved.ShrinkToFit();
+    EXPECT_EQ(moved.Capacity(), 4u);
+}
+
+}  // namespace
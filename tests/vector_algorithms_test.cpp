@@ -0,0 +1,99 @@
+#include "vector_algorithms.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace {
+
+static_assert(SimdVector<Vector<int>>);
+static_assert(SimdVector<Vector<double>>);
+static_assert(!SimdVector<Vector<bool>>);
+static_assert(!SimdVector<Vector<int*>>);
+
+// Размер, при котором остаются и полные регистры, и хвост поэлементной обработки
+constexpr size_t kOddSize = 1000 + 7;
+
+TEST(VectorAlgorithms, FillSumCount) {
+    Vector<int> v(kOddSize);
+    Fill(v, 3);
+    EXPECT_EQ(Sum(v), static_cast<int>(3 * kOddSize));
+    EXPECT_EQ(Count(v, 3), kOddSize);
+    EXPECT_EQ(Count(v, 4), 0u);
+}
+
+TEST(VectorAlgorithms, SignedSumWrapsAround) {
+    Vector<int8_t> v(300);
+    Fill(v, int8_t{100});
+    int8_t expected = 0;
+    for (size_t i = 0; i < v.Size(); ++i) {
+        expected = static_cast<int8_t>(static_cast<uint8_t>(expected) + 100);
+    }
+    EXPECT_EQ(Sum(v), expected);
+    // Счётчики совпадений в дорожках сбрасываются до переполнения однобайтного типа
+    EXPECT_EQ(Count(v, int8_t{100}), 300u);
+}
+
+TEST(VectorAlgorithms, MinMaxFind) {
+    Vector<double> v(kOddSize);
+    for (size_t i = 0; i < v.Size(); ++i) {
+        v[i] = static_cast<double>((i * 37) % 1009);
+    }
+    EXPECT_EQ(Min(v), *std::min_element(v.begin(), v.end()));
+    EXPECT_EQ(Max(v), *std::max_element(v.begin(), v.end()));
+    EXPECT_EQ(Find(v, v[kOddSize - 1]), v.begin() + (kOddSize - 1));
+    EXPECT_EQ(Find(v, -1.0), v.end());
+}
+
+TEST(VectorAlgorithms, EmptyVector) {
+    Vector<float> v;
+    Fill(v, 1.0f);
+    EXPECT_EQ(Sum(v), 0.0f);
+    EXPECT_EQ(Count(v, 0.0f), 0u);
+    EXPECT_EQ(Find(v, 0.0f), v.end());
+}
+
+TEST(VectorAlgorithms, AlignedAndSmallVectors) {
+    Vector<float, AlignedAllocator<float>> aligned(kOddSize);
+    Fill(aligned, 2.0f);
+    EXPECT_EQ(Sum(aligned), 2.0f * kOddSize);
+    SmallVector<int16_t, 5> small(5);
+    Fill(small, int16_t{7});
+    EXPECT_EQ(Count(small, int16_t{7}), 5u);
+}
+
+// Обобщённая лямбда, которую нельзя вызвать для регистра, применяется поэлементно
+TEST(VectorAlgorithms, TransformCallsOpPerElement) {
+    Vector<double> v(kOddSize);
+    for (size_t i = 0; i < v.Size(); ++i) {
+        v[i] = static_cast<double>(i * i);
+    }
+    Transform(v, [](auto x) {
+        return std::sqrt(x);
+    });
+    for (size_t i = 0; i < v.Size(); ++i) {
+        ASSERT_EQ(v[i], static_cast<double>(i));
+    }
+}
+
+TEST(VectorAlgorithms, TransformLanesMatchesTransform) {
+    Vector<int> src(kOddSize);
+    for (size_t i = 0; i < src.Size(); ++i) {
+        src[i] = static_cast<int>(i);
+    }
+    const auto op = [](auto x) {
+        return x * 3 + 1;
+    };
+    Vector<int> by_element;
+    Transform(src, by_element, op);
+    Vector<int> by_lanes;
+    TransformLanes(src, by_lanes, op);
+    EXPECT_EQ(by_lanes, by_element);
+    TransformLanes(src, op);
+    EXPECT_EQ(src, by_element);
+    EXPECT_EQ(src[kOddSize - 1], static_cast<int>(3 * (kOddSize - 1) + 1));
+}
+
+}  // namespace
@@ -0,0 +1,64 @@
+#include "vector.h"
+
+#include "bit_vector.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <utility>
+
+// Файл собирается только в advanced_vector_checked_tests с ADVANCED_VECTOR_CHECK_LEVEL=2
+static_assert(ADVANCED_VECTOR_CHECK_LEVEL == 2);
+
+namespace {
+
+Vector<std::string> MakeStrings(int count) {
+    Vector<std::string> v;
+    for (int i = 0; i < count; ++i) {
+        v.PushBack(std::to_string(i));
+    }
+    return v;
+}
+
+TEST(VectorChecksDeathTest, IndexOutOfRangeTraps) {
+    Vector<std::string> v = MakeStrings(3);
+    EXPECT_DEATH(static_cast<void>(v[3]), "");
+    EXPECT_DEATH(static_cast<void>(v.Subspan(2, 2)), "");
+}
+
+TEST(VectorChecksDeathTest, IteratorAfterReallocationTraps) {
+    Vector<std::string> v = MakeStrings(4);
+    auto it = v.begin() + 1;
+    EXPECT_EQ(*it, "1");
+    v.Reserve(v.Capacity() + 1);
+    EXPECT_DEATH(static_cast<void>(*it), "");
+}
+
+TEST(VectorChecksDeathTest, DereferencingEndTraps) {
+    const Vector<std::string> v = MakeStrings(2);
+    EXPECT_DEATH(static_cast<void>(*v.end()), "");
+}
+
+// Побитовые операции над векторами разной длины и обращение за Size() останавливают программу
+TEST(VectorChecksDeathTest, BitVectorSizeMismatchTraps) {
+    BitVector<> lhs(100, true);
+    const BitVector<> rhs(10, true);
+    EXPECT_DEATH(lhs &= rhs, "");
+    EXPECT_DEATH(lhs |= rhs, "");
+    EXPECT_DEATH(lhs ^= rhs, "");
+    EXPECT_DEATH(static_cast<void>(std::as_const(rhs)[10]), "");
+}
+
+// Итераторы остаются действительными, пока буфер не перевыделяется
+TEST(VectorChecks, IteratorsSurviveInPlaceChanges) {
+    Vector<std::string> v = MakeStrings(2);
+    v.Reserve(10);
+    auto it = v.begin();
+    v.PushBack("2");
+    v.Erase(v.end() - 1);
+    EXPECT_EQ(*it, "0");
+    EXPECT_EQ(it[1], "1");
+    EXPECT_EQ(v.end() - v.begin(), 2);
+}
+
+}  // namespace
@@ -0,0 +1,137 @@
+#include "vector_serialization.h"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <string>
+
+// Строка записывается длиной и байтами
+template <>
+struct VectorElementCodec<std::string> {
+    static void Write(ByteWriter auto& writer, const std::string& value) {
+        const uint64_t size = value.size();
+        writer.Write(std::as_bytes(std::span(&size, 1)));
+        writer.Write(std::as_bytes(std::span(value.data(), value.size())));
+    }
+
+    static std::string Read(ByteReader auto& reader) {
+        uint64_t size = 0;
+        reader.Read(std::as_writable_bytes(std::span(&size, 1)));
+        std::string value(size, '\0');
+        reader.Read(std::as_writable_bytes(std::span(value.data(), value.size())));
+        return value;
+    }
+};
+
+namespace {
+
+// Источник без Remaining(), как сокет или файл: о конце данных он узнаёт только при чтении
+class StreamReader {
+public:
+    explicit StreamReader(std::span<const std::byte> buffer) noexcept
+        : reader_(buffer) {
+    }
+
+    void Read(std::span<std::byte> bytes) {
+        reader_.Read(bytes);
+    }
+
+private:
+    BufferReader reader_;
+};
+
+static_assert(SizedByteReader<BufferReader>);
+static_assert(ByteReader<StreamReader> && !SizedByteReader<StreamReader>);
+
+template <typename T>
+Vector<std::byte> SerializeToBuffer(const Vector<T>& v) {
+    Vector<std::byte> buffer;
+    BufferWriter writer(buffer);
+    Serialize(v, writer);
+    return buffer;
+}
+
+// Буфер с корректным заголовком Vector<T>, обещающим count элементов, и без самих элементов
+template <typename T>
+Vector<std::byte> HeaderOnly(uint64_t count) {
+    Vector<std::byte> buffer = SerializeToBuffer(Vector<T>());
+    VectorHeader header;
+    std::memcpy(&header, buffer.Data(), sizeof(header));
+    header.count = count;
+    std::memcpy(buffer.Data(), &header, sizeof(header));
+    return buffer;
+}
+
+TEST(VectorSerialization, RawRoundTripAndView) {
+    Vector<double> v;
+    for (int i = 0; i < 1000; ++i) {
+        v.PushBack(i * 0.25);
+    }
+    const Vector<std::byte> buffer = SerializeToBuffer(v);
+    BufferReader reader(std::span(buffer.Data(), buffer.Size()));
+    Vector<double> restored;
+    restored.PushBack(-1.0);
+    Deserialize(reader, restored);
+    EXPECT_EQ(restored, v);
+    EXPECT_TRUE(reader.Remaining().empty());
+    const VectorView<double> view(std::span(buffer.Data(), buffer.Size()));
+    ASSERT_EQ(view.Size(), v.Size());
+    EXPECT_EQ(view[999], v[999]);
+    EXPECT_EQ(view.SerializedSize(), buffer.Size());
+}
+
+TEST(VectorSerialization, PerElementRoundTrip) {
+    Vector<std::string> v;
+    v.PushBack("");
+    v.PushBack("one");
+    v.PushBack(std::string(300, 'x'));
+    const Vector<std::byte> buffer = SerializeToBuffer(v);
+    StreamReader reader(std::span(buffer.Data(), buffer.Size()));
+    Vector<std::string> restored;
+    Deserialize(reader, restored);
+    EXPECT_EQ(restored, v);
+}
+
+TEST(VectorSerialization, TruncatedBuffer) {
+    Vector<int> v(100);
+    const Vector<std::byte> buffer = SerializeToBuffer(v);
+    const std::span<const std::byte> truncated(buffer.Data(), buffer.Size() - 1);
+    Vector<int> restored;
+    BufferReader reader(truncated);
+    EXPECT_THROW(Deserialize(reader, restored), SerializationError);
+    StreamReader stream(truncated);
+    EXPECT_THROW(Deserialize(stream, restored), SerializationError);
+    EXPECT_THROW(VectorView<int>{truncated}, SerializationError);
+    BufferReader header_only(std::span(buffer.Data(), sizeof(VectorHeader) - 1));
+    EXPECT_THROW(Deserialize(header_only, restored), SerializationError);
+}
+
+// Огромное число элементов в заголовке не должно приводить к выделению памяти под них
+TEST(VectorSerialization, HugeCountIsRejectedBeforeAllocating) {
+    const uint64_t huge = std::numeric_limits<uint64_t>::max() / sizeof(int) / 2;
+    const Vector<std::byte> ints = HeaderOnly<int>(huge);
+    Vector<int> restored;
+    BufferReader reader(std::span(ints.Data(), ints.Size()));
+    EXPECT_THROW(Deserialize(reader, restored), SerializationError);
+    StreamReader stream(std::span(ints.Data(), ints.Size()));
+    EXPECT_THROW(Deserialize(stream, restored), SerializationError);
+    EXPECT_LE(restored.Capacity(), vector_serialization::ReadChunkElements<int>() * 2);
+
+    const Vector<std::byte> strings = HeaderOnly<std::string>(huge);
+    Vector<std::string> restored_strings;
+    BufferReader strings_reader(std::span(strings.Data(), strings.Size()));
+    EXPECT_THROW(Deserialize(strings_reader, restored_strings), SerializationError);
+}
+
+TEST(VectorSerialization, RejectsOtherElementType) {
+    const Vector<std::byte> buffer = SerializeToBuffer(Vector<int>(4));
+    BufferReader reader(std::span(buffer.Data(), buffer.Size()));
+    Vector<double> restored;
+    EXPECT_THROW(Deserialize(reader, restored), SerializationError);
+}
+
+}  // namespace
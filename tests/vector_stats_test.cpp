@@ -0,0 +1,104 @@
+#include "vector_stats.h"
+
+#include "vector.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace {
+
+template <typename T, typename Tag>
+using CountedVector = Vector<T, std::allocator<T>, DoublingGrowth, 0, CountingVectorStats<Tag>>;
+
+// Элемент без noexcept-конструктора перемещения: вектор растёт копированием
+struct MayThrowOnMove {
+    MayThrowOnMove() = default;
+    MayThrowOnMove(const MayThrowOnMove&) = default;
+    MayThrowOnMove(MayThrowOnMove&&) noexcept(false) {
+    }
+
+    MayThrowOnMove& operator=(const MayThrowOnMove&) = default;
+};
+
+TEST(CountingVectorStats, CountsGrowthAndFinalSizes) {
+    struct Tag {};
+    using Stats = CountingVectorStats<Tag>;
+    Stats::Reset();
+    {
+        CountedVector<std::string, Tag> v;
+        for (int i = 0; i < 5; ++i) {
+            v.PushBack(std::to_string(i));
+        }
+        const CountedVector<std::string, Tag> empty;
+    }
+    const VectorStatsSnapshot snapshot = Stats::Snapshot();
+    // Вместимость растёт как 1, 2, 4, 8; первое выделение пустому вектору переносом не считается
+    EXPECT_EQ(snapshot.allocations, 4u);
+    EXPECT_EQ(snapshot.allocated_bytes, 15 * sizeof(std::string));
+    EXPECT_EQ(snapshot.realocations, 3u);
+    EXPECT_EQ(snapshot.moved_elements, 1u + 2u + 4u);
+    EXPECT_EQ(snapshot.copied_elements, 0u);
+    EXPECT_EQ(snapshot.peak_capacity, 8u);
+    // Вектор, так и не получивший буфер, в гистограмму не попадает
+    EXPECT_EQ(snapshot.final_sizes[0], 0u);
+    EXPECT_EQ(snapshot.final_sizes[3], 1u);
+    Stats::Reset();
+    EXPECT_EQ(Stats::Snapshot().allocations, 0u);
+}
+
+// Векторы, оставшиеся после перемещения и обмена, не искажают гистограмму размеров
+TEST(CountingVectorStats, MovedFromVectorsAreNotRecorded) {
+    struct Tag {};
+    using Stats = CountingVectorStats<Tag>;
+    Stats::Reset();
+    {
+        CountedVector<int, Tag> v;
+        v.Resize(5);
+        CountedVector<int, Tag> moved = std::move(v);
+        CountedVector<int, Tag> swapped;
+        swapped.Swap(moved);
+        CountedVector<int, Tag> reserved;
+        reserved.Reserve(4);
+    }
+    const VectorStatsSnapshot snapshot = Stats::Snapshot();
+    EXPECT_EQ(snapshot.final_sizes[3], 1u);
+    // Пустой вектор с буфером в куче учитывается
+    EXPECT_EQ(snapshot.final_sizes[0], 1u);
+    EXPECT_EQ(snapshot.realocations, 0u);
+}
+
+TEST(CountingVectorStats, ThrowingMoveIsCountedAsCopy) {
+    struct Tag {};
+    using Stats = CountingVectorStats<Tag>;
+    Stats::Reset();
+    CountedVector<MayThrowOnMove, Tag> v;
+    v.Resize(3);
+    v.Reserve(10);
+    EXPECT_EQ(Stats::Snapshot().copied_elements, 3u);
+    EXPECT_EQ(Stats::Snapshot().moved_elements, 0u);
+}
+
+// Векторы с разными тегами ведут счётчики раздельно, а Export отдаёт снимок экспортёру
+TEST(CountingVectorStats, TagsAreIndependentAndExported) {
+    struct First {};
+    struct Second {};
+    CountingVectorStats<First>::Reset();
+    CountingVectorStats<Second>::Reset();
+    CountedVector<int, First> v;
+    v.Reserve(16);
+    EXPECT_EQ(CountingVectorStats<Second>::Snapshot().allocations, 0u);
+
+    size_t exported_peak = 0;
+    CountingVectorStats<First>::Export();
+    CountingVectorStats<First>::SetExporter([&exported_peak](const VectorStatsSnapshot& snapshot) {
+        exported_peak = snapshot.peak_capacity;
+    });
+    CountingVectorStats<First>::Export();
+    CountingVectorStats<First>::SetExporter(nullptr);
+    EXPECT_EQ(exported_peak, 16u);
+}
+
+}  // namespace
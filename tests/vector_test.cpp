@@ -0,0 +1,534 @@
+#include "vector.h"
+
+#include <gtest/gtest.h>
+
+#include <list>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Элемент, копирование которого бросает исключение после заданного числа копий
+struct ThrowOnCopy {
+    static inline int copies_left = -1;
+
+    explicit ThrowOnCopy(int value)
+        : value(value) {
+    }
+
+    ThrowOnCopy(const ThrowOnCopy& other)
+        : value(other.value) {
+        if (copies_left == 0) {
+            throw std::runtime_error("copy");
+        }
+        --copies_left;
+    }
+
+    ThrowOnCopy& operator=(const ThrowOnCopy&) = default;
+
+    int value;
+};
+
+// Ключ без padding-байтов, равенство которого не учитывает версию
+struct VersionedKey {
+    int id;
+    int version;
+
+    bool operator==(const VersionedKey& other) const {
+        return id == other.id;
+    }
+};
+
+// Элемент, который считает вызовы конструкторов перемещения и копирования и деструктора.
+// Если Relocatable, вектор переносит его побайтово
+template <bool Relocatable>
+struct CountedElement {
+    static inline int constructions = 0;
+    static inline int destructions = 0;
+
+    explicit CountedElement(int value)
+        : value(value) {
+    }
+
+    CountedElement(const CountedElement& other)
+        : value(other.value) {
+        ++constructions;
+    }
+
+    CountedElement(CountedElement&& other) noexcept
+        : value(other.value) {
+        ++constructions;
+    }
+
+    CountedElement& operator=(const CountedElement&) = default;
+
+    ~CountedElement() {
+        ++destructions;
+    }
+
+    int value;
+};
+
+}  // namespace
+
+template <>
+struct is_trivially_relocatable<CountedElement<true>> : std::true_type {
+};
+
+namespace {
+
+template <typename V>
+std::vector<typename V::value_type> ToStd(const V& v) {
+    return {v.begin(), v.end()};
+}
+
+TEST(Vector, PushBackInsertErase) {
+    Vector<std::string> v;
+    for (int i = 0; i < 10; ++i) {
+        v.PushBack(std::to_string(i));
+    }
+    v.Insert(v.begin() + 3, "x");
+    v.Erase(v.begin());
+    v.Erase(v.begin() + 1, v.begin() + 3);
+    EXPECT_EQ(ToStd(v), (std::vector<std::string>{"1", "3", "4", "5", "6", "7", "8", "9"}));
+}
+
+TEST(Vector, EmplaceBackFromOwnElement) {
+    Vector<std::string> v;
+    v.PushBack(std::string(100, 'a'));
+    while (v.Size() < v.Capacity()) {
+        v.EmplaceBack("b");
+    }
+    v.EmplaceBack(v[0]);
+    EXPECT_EQ(v[v.Size() - 1], std::string(100, 'a'));
+    v.Insert(v.begin(), v.Size() + 1, v[v.Size() - 1]);
+    EXPECT_EQ(v[0], std::string(100, 'a'));
+}
+
+// Вставка в середину при свободной ёмкости аргументом, который ссылается на элемент вектора:
+// сдвиг хвоста не должен испортить аргумент до построения нового элемента
+TEST(Vector, EmplaceIntoSpareCapacityFromOwnElement) {
+    Vector<std::string> v;
+    v.Reserve(16);
+    for (const char* value : {"a", "b", "c", "d"}) {
+        v.PushBack(std::string(50, value[0]));
+    }
+    const std::string* data = v.Data();
+    v.Emplace(v.begin() + 1, v[3]);
+    v.Emplace(v.begin() + 1, v[2].c_str());
+    v.Insert(v.begin(), std::move(v[4]));
+    EXPECT_EQ(v.Data(), data);
+    // Перемещённый элемент "c" остаётся пустым на своём сдвинутом месте
+    EXPECT_EQ(ToStd(v), (std::vector<std::string>{std::string(50, 'c'), std::string(50, 'a'), std::string(50, 'b'),
+                                                   std::string(50, 'd'), std::string(50, 'b'), std::string(),
+                                                   std::string(50, 'd')}));
+
+    Vector<int> ints;
+    ints.Reserve(8);
+    for (int i = 0; i < 4; ++i) {
+        ints.PushBack(i);
+    }
+    ints.Emplace(ints.begin(), ints[3]);
+    ints.Emplace(ints.begin() + 2, ints[0] + 10);
+    EXPECT_EQ(ToStd(ints), (std::vector<int>{3, 0, 13, 1, 2, 3}));
+}
+
+// EmplaceAtUnchecked строит элемент сразу на месте, не перевыделяя память
+TEST(Vector, EmplaceAtUncheckedConstructsInPlace) {
+    Vector<std::string> v;
+    v.Reserve(8);
+    v.PushBack("a");
+    v.PushBack("c");
+    v.PushBack("d");
+    const std::string* data = v.Data();
+    const auto it = v.EmplaceAtUnchecked(v.begin() + 1, 3, 'b');
+    EXPECT_EQ(*it, "bbb");
+    v.EmplaceAtUnchecked(v.end(), "e");
+    EXPECT_EQ(v.Data(), data);
+    EXPECT_EQ(ToStd(v), (std::vector<std::string>{"a", "bbb", "c", "d", "e"}));
+}
+
+// Добавление в свободную ёмкость и добавление вектора к самому себе с перевыделением
+TEST(Vector, AppendIntoSpareCapacityAndSelf) {
+    Vector<std::string> v;
+    v.Reserve(8);
+    v.Append(std::vector<std::string>{"a", "b"});
+    v.Append(std::list<std::string>{"c"});
+    EXPECT_EQ(v.Capacity(), 8u);
+    v.Append(v);
+    v.Append(v);
+    ASSERT_EQ(v.Size(), 12u);
+    EXPECT_EQ(ToStd(v), (std::vector<std::string>{"a", "b", "c", "a", "b", "c", "a", "b", "c", "a", "b", "c"}));
+}
+
+// EraseIf удаляет подходящие элементы за один проход и сохраняет порядок остальных
+TEST(Vector, EraseIfKeepsOrderOfRemaining) {
+    Vector<std::string> v;
+    for (int i = 0; i < 10; ++i) {
+        v.PushBack(std::to_string(i));
+    }
+    std::vector<std::string> visited;
+    const size_t removed = v.EraseIf([&visited](const std::string& value) {
+        visited.push_back(value);
+        return (value[0] - '0') % 3 == 0;
+    });
+    EXPECT_EQ(removed, 4u);
+    EXPECT_EQ(visited, (std::vector<std::string>{"0", "1", "2", "3", "4", "5", "6", "7", "8", "9"}));
+    EXPECT_EQ(ToStd(v), (std::vector<std::string>{"1", "2", "4", "5", "7", "8"}));
+    EXPECT_EQ(v.EraseIf([](const std::string&) { return false; }), 0u);
+    EXPECT_EQ(v.EraseIf([](const std::string&) { return true; }), 6u);
+    EXPECT_EQ(v.Size(), 0u);
+}
+
+// UnorderedErase ставит на место удалённого последний элемент
+TEST(Vector, UnorderedEraseMovesLastElement) {
+    Vector<std::string> v;
+    for (const char* value : {"a", "b", "c", "d"}) {
+        v.PushBack(value);
+    }
+    auto it = v.UnorderedErase(v.begin() + 1);
+    EXPECT_EQ(it, v.begin() + 1);
+    EXPECT_EQ(ToStd(v), (std::vector<std::string>{"a", "d", "c"}));
+    // Последний элемент просто удаляется, итератор указывает на end()
+    it = v.UnorderedErase(v.begin() + 2);
+    EXPECT_EQ(it, v.end());
+    EXPECT_EQ(ToStd(v), (std::vector<std::string>{"a", "d"}));
+    v.UnorderedErase(v.begin());
+    EXPECT_EQ(ToStd(v), (std::vector<std::string>{"d"}));
+    v.UnorderedErase(v.begin());
+    EXPECT_EQ(v.Size(), 0u);
+}
+
+TEST(Vector, CopyMoveSwapRoundTrip) {
+    Vector<std::string> v(5);
+    v[2] = "two";
+    Vector<std::string> copy = v;
+    EXPECT_EQ(copy, v);
+    Vector<std::string> moved = std::move(copy);
+    EXPECT_EQ(moved, v);
+    EXPECT_EQ(copy.Size(), 0u);
+    Vector<std::string> other;
+    other.Swap(moved);
+    EXPECT_EQ(other, v);
+    EXPECT_EQ(moved.Size(), 0u);
+}
+
+// Побайтовое сравнение не должно подменять operator== элемента
+TEST(Vector, EqualityUsesElementOperator) {
+    static_assert(std::has_unique_object_representations_v<VersionedKey>);
+    Vector<VersionedKey> lhs;
+    Vector<VersionedKey> rhs;
+    lhs.PushBack({1, 1});
+    lhs.PushBack({2, 1});
+    rhs.PushBack({1, 2});
+    rhs.PushBack({2, 3});
+    EXPECT_EQ(lhs, rhs);
+    rhs[1].id = 3;
+    EXPECT_NE(lhs, rhs);
+
+    Vector<int> ints(3);
+    Vector<int> other_ints(3);
+    EXPECT_EQ(ints, other_ints);
+    other_ints[2] = 4;
+    EXPECT_NE(ints, other_ints);
+}
+
+// Вместимости, которые вектор проходит при добавлении count элементов по одному
+template <typename GrowthPolicy>
+std::vector<size_t> CapacitySequence(size_t count) {
+    Vector<int, std::allocator<int>, GrowthPolicy> v;
+    std::vector<size_t> capacities;
+    for (size_t i = 0; i < count; ++i) {
+        v.PushBack(static_cast<int>(i));
+        if (capacities.empty() || capacities.back() != v.Capacity()) {
+            capacities.push_back(v.Capacity());
+        }
+    }
+    return capacities;
+}
+
+TEST(Vector, GrowthPoliciesProduceExpectedCapacities) {
+    EXPECT_EQ(CapacitySequence<DoublingGrowth>(17), (std::vector<size_t>{1, 2, 4, 8, 16, 32}));
+    EXPECT_EQ(CapacitySequence<OneAndHalfGrowth>(14), (std::vector<size_t>{1, 2, 3, 4, 6, 9, 13, 19}));
+    EXPECT_EQ((CapacitySequence<MinCapacityGrowth<8>>(17)), (std::vector<size_t>{8, 16, 32}));
+    // Размер буфера округляется до размерного класса: 16, 32, 48, 80, 128, 192, 320 байт
+    EXPECT_EQ(CapacitySequence<SizeClassGrowth<OneAndHalfGrowth>>(49),
+              (std::vector<size_t>{4, 8, 12, 20, 32, 48, 80}));
+    // Удвоение до 64 байт, дальше шагами по 32 байта
+    EXPECT_EQ((CapacitySequence<CappedLinearGrowth<64, 32>>(33)), (std::vector<size_t>{1, 2, 4, 8, 16, 24, 32, 40}));
+}
+
+// Тривиально перемещаемые элементы переносятся при росте побайтово: без конструкторов и деструкторов
+TEST(Vector, TriviallyRelocatableElementsAreMemcopied) {
+    static_assert(is_trivially_relocatable_v<CountedElement<true>>);
+    static_assert(!is_trivially_relocatable_v<CountedElement<false>>);
+    auto grow = []<bool Relocatable>(std::bool_constant<Relocatable>) {
+        using Element = CountedElement<Relocatable>;
+        Vector<Element> v;
+        v.Reserve(4);
+        for (int i = 0; i < 4; ++i) {
+            v.EmplaceBack(i);
+        }
+        Element::constructions = Element::destructions = 0;
+        v.Reserve(64);
+        EXPECT_EQ(v[3].value, 3);
+        return std::pair(Element::constructions, Element::destructions);
+    };
+    EXPECT_EQ(grow(std::true_type{}), std::pair(0, 0));
+    EXPECT_EQ(grow(std::false_type{}), std::pair(4, 4));
+}
+
+TEST(Vector, FailedGrowthKeepsElements) {
+    Vector<ThrowOnCopy> v;
+    v.Reserve(2);
+    v.EmplaceBack(1);
+    v.EmplaceBack(2);
+    ThrowOnCopy::copies_left = 1;
+    EXPECT_THROW(v.EmplaceBack(3), std::runtime_error);
+    ThrowOnCopy::copies_left = -1;
+    ASSERT_EQ(v.Size(), 2u);
+    EXPECT_EQ(v[0].value, 1);
+    EXPECT_EQ(v[1].value, 2);
+}
+
+// Вектор остаётся ровно того размера, который вернула op, а лишние элементы разрушаются
+TEST(Vector, ResizeAndOverwriteKeepsReturnedCount) {
+    const auto token = std::make_shared<int>(0);
+    Vector<std::shared_ptr<int>> v;
+    for (int i = 0; i < 8; ++i) {
+        v.PushBack(token);
+    }
+    ASSERT_EQ(token.use_count(), 9);
+    v.ResizeAndOverwrite(6, [](std::shared_ptr<int>* data, size_t count) {
+        EXPECT_EQ(count, 6u);
+        data[0].reset();
+        return size_t{3};
+    });
+    ASSERT_EQ(v.Size(), 3u);
+    EXPECT_EQ(v[0], nullptr);
+    // Два элемента разрушены уменьшением до 6, ещё три — после того, как op вернула 3
+    EXPECT_EQ(token.use_count(), 3);
+}
+
+// Рост за пределы вместимости сохраняет прежние элементы, новые op записывает сама
+TEST(Vector, ResizeAndOverwriteGrowsPastCapacity) {
+    Vector<int> v;
+    for (int i = 0; i < 4; ++i) {
+        v.PushBack(i);
+    }
+    const size_t old_capacity = v.Capacity();
+    v.ResizeAndOverwrite(100, [](int* data, size_t count) {
+        for (size_t i = 4; i < count; ++i) {
+            data[i] = static_cast<int>(i);
+        }
+        return count - 10;
+    });
+    EXPECT_GT(v.Capacity(), old_capacity);
+    ASSERT_EQ(v.Size(), 90u);
+    for (size_t i = 0; i < v.Size(); ++i) {
+        ASSERT_EQ(v[i], static_cast<int>(i));
+    }
+}
+
+TEST(Vector, DefaultInitConstructionAndResize) {
+    Vector<std::string> strings(3, default_init);
+    EXPECT_EQ(ToStd(strings), (std::vector<std::string>(3)));
+    Vector<int> ints(2, default_init);
+    ints[0] = 1;
+    ints[1] = 2;
+    ints.ResizeDefaultInit(5);
+    ASSERT_EQ(ints.Size(), 5u);
+    EXPECT_EQ(ints[0], 1);
+    EXPECT_EQ(ints[1], 2);
+    ints.ResizeDefaultInit(1);
+    EXPECT_EQ(ints.Size(), 1u);
+    EXPECT_EQ(ints[0], 1);
+}
+
+TEST(SmallVector, InlineAndHeapRoundTrip) {
+    SmallVector<std::string, 4> v;
+    v.PushBack("a");
+    v.PushBack("b");
+    EXPECT_EQ(v.Capacity(), 4u);
+    SmallVector<std::string, 4> moved = std::move(v);
+    EXPECT_EQ(ToStd(moved), (std::vector<std::string>{"a", "b"}));
+    for (int i = 0; i < 10; ++i) {
+        moved.PushBack(std::to_string(i));
+    }
+    EXPECT_GT(moved.Capacity(), 4u);
+    moved.Resize(3);
+    moved.ShrinkToFit();
+    EXPECT_EQ(moved.Capacity(), 4u);
+    EXPECT_EQ(ToStd(moved), (std::vector<std::string>{"a", "b", "0"}));
+}
+
+TEST(Vector, ShrinkToFitReleasesEmptyBuffer) {
+    Vector<std::string> v;
+    v.Reserve(10);
+    v.PushBack("a");
+    v.PopBack();
+    v.ShrinkToFit();
+    EXPECT_EQ(v.Capacity(), 0u);
+    v.PushBack("b");
+    EXPECT_EQ(v[0], "b");
+    SmallVector<std::string, 2> small;
+    small.Reserve(10);
+    small.ShrinkToFit();
+    EXPECT_EQ(small.Capacity(), 2u);
+}
+
+// ShrinkingGrowth вдвое уменьшает вместимость, когда элементов меньше четверти, и не
+// перевыделяет память при колебаниях размера около этого порога
+TEST(Vector, ShrinkingGrowthHalvesWithHysteresis) {
+    Vector<int, std::allocator<int>, ShrinkingGrowth<>> v;
+    for (int i = 0; i < 64; ++i) {
+        v.PushBack(i);
+    }
+    ASSERT_EQ(v.Capacity(), 64u);
+    while (v.Size() > 16) {
+        v.PopBack();
+    }
+    EXPECT_EQ(v.Capacity(), 64u);
+    v.PopBack();
+    EXPECT_EQ(v.Capacity(), 30u);
+    for (int round = 0; round < 10; ++round) {
+        v.PushBack(0);
+        v.PopBack();
+    }
+    EXPECT_EQ(v.Capacity(), 30u);
+    v.Erase(v.begin(), v.begin() + 9);
+    EXPECT_EQ(v.Size(), 6u);
+    EXPECT_EQ(v.Capacity(), 12u);
+    EXPECT_EQ(v.EraseIf([](int value) { return value < 13; }), 4u);
+    EXPECT_EQ(v.Capacity(), 4u);
+    EXPECT_EQ(ToStd(v), (std::vector<int>{13, 14}));
+}
+
+TEST(Vector, ClearAndReleaseFreesBuffer) {
+    Vector<std::string> v;
+    for (int i = 0; i < 10; ++i) {
+        v.PushBack(std::to_string(i));
+    }
+    v.ClearAndRelease();
+    EXPECT_EQ(v.Size(), 0u);
+    EXPECT_EQ(v.Capacity(), 0u);
+    v.PushBack("a");
+    EXPECT_EQ(v[0], "a");
+    SmallVector<std::string, 4> small;
+    for (int i = 0; i < 10; ++i) {
+        small.PushBack(std::to_string(i));
+    }
+    small.ClearAndRelease();
+    EXPECT_EQ(small.Size(), 0u);
+    EXPECT_EQ(small.Capacity(), 4u);
+}
+
+TEST(Vector, ReleaseAdoptRoundTrip) {
+    Vector<int> v;
+    for (int i = 0; i < 100; ++i) {
+        v.PushBack(i);
+    }
+    const VectorBuffer<int> buffer = v.Release();
+    EXPECT_EQ(v.Size(), 0u);
+    Vector<int> adopted;
+    adopted.Adopt(buffer);
+    ASSERT_EQ(adopted.Size(), 100u);
+    EXPECT_EQ(adopted[99], 99);
+}
+
+// Размер, при котором копирование и перенос делятся на несколько потоков
+constexpr size_t kParallelSize = vector_parallel::kMinChunkSize * 4 + 3;
+
+TEST(Vector, ParallelCopyReserveClear) {
+    Vector<std::string> v;
+    for (size_t i = 0; i < kParallelSize; ++i) {
+        v.PushBack(std::to_string(i));
+    }
+    const Vector<std::string> copy(v, parallel);
+    EXPECT_EQ(ToStd(copy), ToStd(v));
+    v.Reserve(v.Capacity() * 2, parallel);
+    EXPECT_EQ(ToStd(v), ToStd(copy));
+    v.Clear(parallel);
+    EXPECT_EQ(v.Size(), 0u);
+    EXPECT_EQ(copy[kParallelSize - 1], std::to_string(kParallelSize - 1));
+    const Vector<std::string> empty(v, parallel);
+    EXPECT_EQ(empty.Size(), 0u);
+}
+
+// Параллельные копирования из нескольких потоков делят один пул
+TEST(Vector, ParallelCopiesFromSeveralThreads) {
+    Vector<std::string> v;
+    for (size_t i = 0; i < kParallelSize; ++i) {
+        v.PushBack(std::to_string(i));
+    }
+    std::vector<std::thread> threads;
+    std::vector<size_t> matches(4);
+    for (size_t t = 0; t < matches.size(); ++t) {
+        threads.emplace_back([&v, &matches, t] {
+            for (int round = 0; round < 3; ++round) {
+                const Vector<std::string> copy(v, parallel);
+                matches[t] += copy == v ? 1 : 0;
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(matches, std::vector<size_t>(matches.size(), 3));
+}
+
+// Случайные операции над Vector сверяются с тем же над std::vector
+TEST(Vector, MatchesStdVector) {
+    std::mt19937 rng(42);
+    Vector<std::string> v;
+    std::vector<std::string> ref;
+    for (int step = 0; step < 5000; ++step) {
+        const size_t n = ref.size();
+        const size_t pos = n == 0 ? 0 : rng() % (n + 1);
+        const std::string value = std::to_string(rng());
+        switch (rng() % 7) {
+            case 0:
+            case 1:
+                v.PushBack(value);
+                ref.push_back(value);
+                break;
+            case 2:
+                v.Insert(v.begin() + pos, value);
+                ref.insert(ref.begin() + pos, value);
+                break;
+            case 3:
+                if (pos < n) {
+                    v.Erase(v.begin() + pos);
+                    ref.erase(ref.begin() + pos);
+                }
+                break;
+            case 4: {
+                const size_t count = rng() % 8;
+                v.Insert(v.begin() + pos, count, value);
+                ref.insert(ref.begin() + pos, count, value);
+                break;
+            }
+            case 5: {
+                const std::list<std::string> values(rng() % 4, value);
+                v.Insert(v.begin() + pos, values.begin(), values.end());
+                ref.insert(ref.begin() + pos, values.begin(), values.end());
+                break;
+            }
+            case 6: {
+                const size_t size = rng() % 50;
+                v.Resize(size);
+                ref.resize(size);
+                break;
+            }
+        }
+        ASSERT_EQ(ToStd(v), ref) << "step " << step;
+    }
+}
+
+}  // namespace